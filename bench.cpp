@@ -0,0 +1,119 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <string>
+
+#include "maze.hpp"
+
+/*
+ * Benchmarks the fused generate-and-solve pipeline against a file round trip
+ * (generate, write the maze, read it back in, solve), in both the hex and the
+ * packed formats. Every variant ends by writing the pruned path, solving from
+ * the top left to the bottom right corner.
+ *
+ * The round trip uses libmaze's own maze_save and maze_load, not the
+ * generator and solver programs: those keep the grid in stack arrays and
+ * cannot run at benchmark sizes. maze_save and maze_load write and read hex
+ * a row at a time with fwrite and getc, which is faster than the programs'
+ * fprintf("%x") and fscanf("%1x") per room, so the gap between fused and a
+ * real generator -> file -> solver run is larger than this reports.
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void write_path(const libmaze::Maze &maze, const std::string &path_file) {
+    std::FILE *f = std::fopen(path_file.c_str(), "w");
+    if (f == nullptr) {
+        throw std::runtime_error("could not open " + path_file);
+    }
+    try {
+        maze.write_pruned_path(0, 0, f);
+    } catch (...) {
+        std::fclose(f);
+        throw;
+    }
+    if (std::fclose(f) == EOF) {
+        throw std::runtime_error("could not close " + path_file);
+    }
+}
+
+double run_fused(int num_rows, int num_cols, unsigned int seed,
+                 const std::string &path_file) {
+    Clock::time_point start = Clock::now();
+    libmaze::Maze maze(num_rows, num_cols);
+    maze.generate_and_solve(seed, 0, 0, num_rows - 1, num_cols - 1);
+    write_path(maze, path_file);
+    return seconds_since(start);
+}
+
+double run_round_trip(int num_rows, int num_cols, unsigned int seed,
+                      const std::string &maze_file,
+                      const std::string &path_file) {
+    Clock::time_point start = Clock::now();
+    {
+        libmaze::Maze generated(num_rows, num_cols);
+        generated.generate(seed);
+        generated.save(maze_file);
+    }
+    libmaze::Maze maze = libmaze::Maze::load(maze_file, num_rows, num_cols);
+    maze.solve(0, 0, num_rows - 1, num_cols - 1);
+    write_path(maze, path_file);
+    return seconds_since(start);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    if (argc < 3 || argc > 5) {
+        std::printf("Incorrect number of arguments.\n");
+        std::printf("./maze_bench <number of rows> <number of columns>"
+                    " [<runs>] [<scratch directory>]\n");
+        return 1;
+    }
+    int num_rows = std::atoi(argv[1]);
+    int num_cols = std::atoi(argv[2]);
+    int runs = argc > 3 ? std::atoi(argv[3]) : 3;
+    std::string dir = argc > 4 ? argv[4] : "/tmp";
+    if (num_rows <= 0 || num_cols <= 0 || runs <= 0) {
+        return 1;
+    }
+
+    std::string hex_file = dir + "/maze_bench.txt";
+    std::string packed_file = dir + "/maze_bench.mzp";
+    std::string path_file = dir + "/maze_bench_path.txt";
+    double fused = 0, hex = 0, packed = 0;
+
+    try {
+        for (int i = 0; i < runs; i++) {
+            unsigned int seed = 330 + i;
+            double t = run_fused(num_rows, num_cols, seed, path_file);
+            fused = (i == 0 || t < fused) ? t : fused;
+            t = run_round_trip(num_rows, num_cols, seed, hex_file, path_file);
+            hex = (i == 0 || t < hex) ? t : hex;
+            t = run_round_trip(num_rows, num_cols, seed, packed_file,
+                               path_file);
+            packed = (i == 0 || t < packed) ? t : packed;
+        }
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    std::remove(hex_file.c_str());
+    std::remove(packed_file.c_str());
+    std::remove(path_file.c_str());
+
+    std::printf("%d x %d maze, best of %d runs\n", num_rows, num_cols, runs);
+    std::printf("  fused:                       %8.3f s\n", fused);
+    std::printf("  libmaze round trip (hex):    %8.3f s  (%.2fx fused)\n",
+                hex, hex / fused);
+    std::printf("  libmaze round trip (packed): %8.3f s  (%.2fx fused)\n",
+                packed, packed / fused);
+    return 0;
+}
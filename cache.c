@@ -0,0 +1,267 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cache.h"
+
+/*
+ * An entry in the cache. Entries are chained into a hash bucket through
+ * hash_next, and into the recency list (most recently used first) through
+ * prev and next.
+ */
+struct lru_entry {
+    char *key;
+    uint64_t hash;
+    void *value;
+    size_t size;
+    struct lru_entry *hash_next;
+    struct lru_entry *prev;
+    struct lru_entry *next;
+};
+
+struct lru_cache {
+    struct lru_entry **buckets;
+    size_t num_buckets;
+    size_t count;
+    size_t size;
+    size_t capacity;
+    struct lru_entry *head;
+    struct lru_entry *tail;
+    void (*free_value)(void *);
+};
+
+/*
+ * FNV-1a hash of a string
+ */
+static uint64_t hash_key(const char *key) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (; *key != '\0'; key++) {
+        hash ^= (unsigned char)*key;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/*
+ * Creates an empty cache
+ *
+ * Parameters:
+ *  - capacity: the most bytes of values the cache may hold at once
+ *  - free_value: called on each value the cache evicts or is destroyed with
+ *
+ * Returns:
+ *  - the new cache, or NULL if memory runs out
+ */
+struct lru_cache *lru_create(size_t capacity, void (*free_value)(void *)) {
+    struct lru_cache *cache = calloc(1, sizeof(struct lru_cache));
+    if (cache == NULL) {
+        return NULL;
+    }
+    cache->num_buckets = 64;
+    cache->buckets = calloc(cache->num_buckets, sizeof(struct lru_entry *));
+    if (cache->buckets == NULL) {
+        free(cache);
+        return NULL;
+    }
+    cache->capacity = capacity;
+    cache->free_value = free_value;
+    return cache;
+}
+
+/*
+ * Frees a cache and every value still in it. Does nothing if cache is NULL.
+ */
+void lru_destroy(struct lru_cache *cache) {
+    if (cache == NULL) {
+        return;
+    }
+    struct lru_entry *e = cache->head;
+    while (e != NULL) {
+        struct lru_entry *next = e->next;
+        cache->free_value(e->value);
+        free(e->key);
+        free(e);
+        e = next;
+    }
+    free(cache->buckets);
+    free(cache);
+}
+
+static void unlink_recency(struct lru_cache *cache, struct lru_entry *e) {
+    if (e->prev != NULL) {
+        e->prev->next = e->next;
+    } else {
+        cache->head = e->next;
+    }
+    if (e->next != NULL) {
+        e->next->prev = e->prev;
+    } else {
+        cache->tail = e->prev;
+    }
+}
+
+static void push_front(struct lru_cache *cache, struct lru_entry *e) {
+    e->prev = NULL;
+    e->next = cache->head;
+    if (cache->head != NULL) {
+        cache->head->prev = e;
+    } else {
+        cache->tail = e;
+    }
+    cache->head = e;
+}
+
+/*
+ * Removes an entry from the cache and frees it along with its value
+ */
+static void remove_entry(struct lru_cache *cache, struct lru_entry *e) {
+    struct lru_entry **link = &cache->buckets[e->hash & (cache->num_buckets - 1)];
+    while (*link != e) {
+        link = &(*link)->hash_next;
+    }
+    *link = e->hash_next;
+    unlink_recency(cache, e);
+    cache->count--;
+    cache->size -= e->size;
+    cache->free_value(e->value);
+    free(e->key);
+    free(e);
+}
+
+static struct lru_entry *find_entry(const struct lru_cache *cache,
+                                    const char *key, uint64_t hash) {
+    struct lru_entry *e = cache->buckets[hash & (cache->num_buckets - 1)];
+    while (e != NULL && (e->hash != hash || strcmp(e->key, key) != 0)) {
+        e = e->hash_next;
+    }
+    return e;
+}
+
+/*
+ * Doubles the number of hash buckets. If memory runs out the cache keeps its
+ * current buckets, which only makes lookups slower.
+ */
+static void grow_buckets(struct lru_cache *cache) {
+    size_t num_buckets = 2 * cache->num_buckets;
+    struct lru_entry **buckets = calloc(num_buckets, sizeof(struct lru_entry *));
+    if (buckets == NULL) {
+        return;
+    }
+    for (struct lru_entry *e = cache->head; e != NULL; e = e->next) {
+        struct lru_entry **bucket = &buckets[e->hash & (num_buckets - 1)];
+        e->hash_next = *bucket;
+        *bucket = e;
+    }
+    free(cache->buckets);
+    cache->buckets = buckets;
+    cache->num_buckets = num_buckets;
+}
+
+/*
+ * Looks up a key, marking it as the most recently used if it is found
+ *
+ * Parameters:
+ *  - cache: the cache to look in
+ *  - key: the key to look up
+ *
+ * Returns:
+ *  - the value stored under key, or NULL if there is none. The value still
+ *    belongs to the cache and is only valid until the next lru_put.
+ */
+void *lru_get(struct lru_cache *cache, const char *key) {
+    struct lru_entry *e = find_entry(cache, key, hash_key(key));
+    if (e == NULL) {
+        return NULL;
+    }
+    unlink_recency(cache, e);
+    push_front(cache, e);
+    return e->value;
+}
+
+/*
+ * Stores a value under a key as the most recently used entry, replacing any
+ * value already stored under it and evicting least recently used entries
+ * until everything fits
+ *
+ * Parameters:
+ *  - cache: the cache to store in
+ *  - key: the key to store under (copied)
+ *  - value: the value to store
+ *  - size: the size of the value in bytes
+ *
+ * Returns:
+ *  - 0 if the value was stored and now belongs to the cache, 1 if it is
+ *    larger than the cache's capacity or memory runs out, in which case it
+ *    still belongs to the caller
+ */
+int lru_put(struct lru_cache *cache, const char *key, void *value,
+            size_t size) {
+    if (size > cache->capacity) {
+        return 1;
+    }
+    uint64_t hash = hash_key(key);
+    struct lru_entry *old = find_entry(cache, key, hash);
+    if (old != NULL) {
+        remove_entry(cache, old);
+    }
+    lru_reserve(cache, size);
+
+    struct lru_entry *e = malloc(sizeof(struct lru_entry));
+    if (e == NULL) {
+        return 1;
+    }
+    e->key = malloc(strlen(key) + 1);
+    if (e->key == NULL) {
+        free(e);
+        return 1;
+    }
+    strcpy(e->key, key);
+    e->hash = hash;
+    e->value = value;
+    e->size = size;
+
+    if (cache->count >= cache->num_buckets) {
+        grow_buckets(cache);
+    }
+    struct lru_entry **bucket = &cache->buckets[hash & (cache->num_buckets - 1)];
+    e->hash_next = *bucket;
+    *bucket = e;
+    push_front(cache, e);
+    cache->count++;
+    cache->size += size;
+    return 0;
+}
+
+/*
+ * Evicts least recently used entries until a value of the given size would
+ * fit, so that callers can free memory before building a large value rather
+ * than after
+ *
+ * Parameters:
+ *  - cache: the cache to make room in
+ *  - size: the size of the value that is about to be put in, in bytes
+ *
+ * Returns:
+ *  - 1 if the value is larger than the cache's capacity, 0 otherwise
+ */
+int lru_reserve(struct lru_cache *cache, size_t size) {
+    if (size > cache->capacity) {
+        return 1;
+    }
+    while (cache->size + size > cache->capacity) {
+        remove_entry(cache, cache->tail);
+    }
+    return 0;
+}
+
+size_t lru_capacity(const struct lru_cache *cache) {
+    return cache->capacity;
+}
+
+size_t lru_count(const struct lru_cache *cache) {
+    return cache->count;
+}
+
+size_t lru_size(const struct lru_cache *cache) {
+    return cache->size;
+}
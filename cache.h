@@ -0,0 +1,32 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stddef.h>
+
+/*
+ * A least recently used cache from strings to values, capped by the total
+ * size of its values. Each value is put in with its size in bytes; when a new
+ * value would take the cache over its capacity, the least recently used
+ * values are freed (with the free_value function given to lru_create) until
+ * it fits.
+ */
+struct lru_cache;
+
+struct lru_cache *lru_create(size_t capacity, void (*free_value)(void *));
+
+void lru_destroy(struct lru_cache *cache);
+
+void *lru_get(struct lru_cache *cache, const char *key);
+
+int lru_put(struct lru_cache *cache, const char *key, void *value,
+            size_t size);
+
+int lru_reserve(struct lru_cache *cache, size_t size);
+
+size_t lru_capacity(const struct lru_cache *cache);
+
+size_t lru_count(const struct lru_cache *cache);
+
+size_t lru_size(const struct lru_cache *cache);
+
+#endif
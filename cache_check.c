@@ -0,0 +1,202 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cache.h"
+
+/*
+ * Checks cache.c directly: which entries are evicted and when, replacing a
+ * key, and that the count and size stay right as entries come and go.
+ */
+
+#define MAX_FREED 4096
+
+/*
+ * Values are heap-allocated ints, and every value the cache frees is
+ * recorded here in order
+ */
+static int freed[MAX_FREED];
+static int num_freed = 0;
+
+static void free_value(void *value) {
+    if (num_freed < MAX_FREED) {
+        freed[num_freed] = *(int *)value;
+    }
+    num_freed++;
+    free(value);
+}
+
+static int *new_value(int id) {
+    int *value = malloc(sizeof(int));
+    if (value == NULL) {
+        fprintf(stderr, "Could not allocate value.\n");
+        exit(1);
+    }
+    *value = id;
+    return value;
+}
+
+/*
+ * Puts a value with the given id under the key, failing the check if the
+ * cache does not take it
+ */
+static int put(struct lru_cache *cache, const char *key, int id, size_t size) {
+    int *value = new_value(id);
+    if (lru_put(cache, key, value, size) == 1) {
+        free(value);
+        printf("lru_put(%s) failed\n", key);
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * Checks that a key holds the value with the given id, or is absent if id is
+ * -1
+ */
+static int holds(struct lru_cache *cache, const char *key, int id) {
+    int *value = lru_get(cache, key);
+    if ((id == -1 && value != NULL) || (id != -1 && (value == NULL ||
+                                                     *value != id))) {
+        printf("%s: expected %d\n", key, id);
+        return 1;
+    }
+    return 0;
+}
+
+static int has_state(struct lru_cache *cache, size_t count, size_t size,
+                     int expected_freed) {
+    if (lru_count(cache) != count || lru_size(cache) != size ||
+        num_freed != expected_freed) {
+        printf("expected %zu entries, %zu bytes, %d freed; got %zu, %zu, %d\n",
+               count, size, expected_freed, lru_count(cache), lru_size(cache),
+               num_freed);
+        return 1;
+    }
+    return 0;
+}
+
+static int check_eviction_order(void) {
+    struct lru_cache *cache = lru_create(30, free_value);
+    if (cache == NULL) {
+        return 1;
+    }
+    num_freed = 0;
+    int err = put(cache, "a", 1, 10) || put(cache, "b", 2, 10) ||
+              put(cache, "c", 3, 10) || has_state(cache, 3, 30, 0) ||
+              // using a makes b the least recently used
+              holds(cache, "a", 1) || put(cache, "d", 4, 10) ||
+              has_state(cache, 3, 30, 1) || holds(cache, "b", -1) ||
+              // c is now the least recently used, and a 20 byte value needs
+              // it and a gone
+              put(cache, "e", 5, 20) || has_state(cache, 2, 30, 3) ||
+              holds(cache, "c", -1) || holds(cache, "a", -1) ||
+              holds(cache, "d", 4) || holds(cache, "e", 5);
+    if (err == 0 && (freed[0] != 2 || freed[1] != 3 || freed[2] != 1)) {
+        printf("evicted %d, %d, %d instead of 2, 3, 1\n", freed[0], freed[1],
+               freed[2]);
+        err = 1;
+    }
+    lru_destroy(cache);
+    if (err == 0 && num_freed != 5) {
+        printf("lru_destroy freed %d values instead of 2\n", num_freed - 3);
+        err = 1;
+    }
+    return err;
+}
+
+static int check_reserve(void) {
+    struct lru_cache *cache = lru_create(30, free_value);
+    if (cache == NULL) {
+        return 1;
+    }
+    num_freed = 0;
+    int err = put(cache, "a", 1, 10) || put(cache, "b", 2, 10) ||
+              put(cache, "c", 3, 10) ||
+              // too large: nothing may be evicted for it
+              lru_reserve(cache, 31) != 1 || has_state(cache, 3, 30, 0) ||
+              // evicts the two oldest before the value exists at all
+              lru_reserve(cache, 20) != 0 || has_state(cache, 1, 10, 2) ||
+              holds(cache, "c", 3) || lru_reserve(cache, 20) != 0 ||
+              has_state(cache, 1, 10, 2);
+    if (err == 0 && (freed[0] != 1 || freed[1] != 2)) {
+        printf("reserve evicted %d, %d instead of 1, 2\n", freed[0], freed[1]);
+        err = 1;
+    }
+    lru_destroy(cache);
+    return err;
+}
+
+static int check_replace(void) {
+    struct lru_cache *cache = lru_create(30, free_value);
+    if (cache == NULL) {
+        return 1;
+    }
+    num_freed = 0;
+    int err = put(cache, "a", 1, 10) || put(cache, "b", 2, 10) ||
+              // replacing frees the old value and takes on the new size
+              put(cache, "a", 3, 5) || has_state(cache, 2, 15, 1) ||
+              holds(cache, "a", 3) || freed[0] != 1 ||
+              // the replacement is the most recently used, so b goes first
+              put(cache, "c", 4, 20) || has_state(cache, 2, 25, 2) ||
+              holds(cache, "b", -1) || freed[1] != 2;
+    // a value larger than the cache is refused and stays the caller's
+    int *big = new_value(5);
+    if (err == 0 && (lru_put(cache, "d", big, 31) != 1 ||
+                     has_state(cache, 2, 25, 2) || holds(cache, "d", -1))) {
+        printf("a value larger than the cache was taken\n");
+        err = 1;
+    }
+    free(big);
+    lru_destroy(cache);
+    return err;
+}
+
+static int check_many(void) {
+    struct lru_cache *cache = lru_create(1000, free_value);
+    if (cache == NULL) {
+        return 1;
+    }
+    num_freed = 0;
+    char key[32];
+    int err = 0;
+    // enough entries to grow the hash table several times, then twice as
+    // many again so the first half is evicted
+    for (int i = 0; i < 2000 && err == 0; i++) {
+        snprintf(key, sizeof(key), "key %d", i);
+        err = put(cache, key, i, 1);
+    }
+    err = err || has_state(cache, 1000, 1000, 1000);
+    for (int i = 0; i < 2000 && err == 0; i++) {
+        snprintf(key, sizeof(key), "key %d", i);
+        err = holds(cache, key, i < 1000 ? -1 : i);
+    }
+    for (int i = 0; i < 1000 && err == 0; i++) {
+        if (freed[i] != i) {
+            printf("eviction %d was of %d\n", i, freed[i]);
+            err = 1;
+        }
+    }
+    lru_destroy(cache);
+    return err;
+}
+
+int main(void) {
+    if (check_eviction_order() == 1) {
+        printf("eviction order check failed\n");
+        return 1;
+    }
+    if (check_reserve() == 1) {
+        printf("lru_reserve check failed\n");
+        return 1;
+    }
+    if (check_replace() == 1) {
+        printf("replacement check failed\n");
+        return 1;
+    }
+    if (check_many() == 1) {
+        printf("many-entry check failed\n");
+        return 1;
+    }
+    printf("cache checks passed\n");
+    return 0;
+}
@@ -0,0 +1,159 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "generator.h"
+#include "maze.h"
+#include "solver.h"
+
+/*
+ * Checks that libmaze's maze_generate and maze_solve, which walk with an
+ * explicit stack, give exactly the same results as the recursive
+ * drunken_walk and dfs the generator and solver programs use: the same maze
+ * for the same seed, and the same PRUNED path (or, when built with FULL, the
+ * same FULL trace) for the same start and goal.
+ */
+
+#define NUM_CASES 200
+#define MAX_SIDE 40
+
+/*
+ * Small generator for the test cases themselves, kept apart from rand() so
+ * picking a case doesn't disturb the sequence the mazes are generated from
+ */
+static unsigned int next_case_value(unsigned int *state, unsigned int bound) {
+    *state = *state * 1103515245u + 12345u;
+    return (*state >> 16) % bound;
+}
+
+/*
+ * Checks whether two files have the same contents, from their starts
+ *
+ * Returns:
+ *  - 1 if they are the same, 0 otherwise
+ */
+static int same_contents(FILE *a, FILE *b) {
+    rewind(a);
+    rewind(b);
+    int c;
+    do {
+        c = getc(a);
+        if (c != getc(b)) {
+            return 0;
+        }
+    } while (c != EOF);
+    return 1;
+}
+
+/*
+ * Runs one case
+ *
+ * Parameters:
+ *  - num_rows, num_cols: size of the maze
+ *  - seed: seed for both generators
+ *  - start_row, start_col, goal_row, goal_col: the query to solve
+ *
+ * Returns:
+ *  - 1 if the results differ or an error occurs, 0 otherwise
+ */
+static int check_case(int num_rows, int num_cols, unsigned int seed,
+                      int start_row, int start_col, int goal_row,
+                      int goal_col) {
+    struct maze_room(*maze)[num_cols] =
+        malloc(sizeof(struct maze_room) * num_rows * num_cols);
+    int(*encoded)[num_cols] = malloc(sizeof(int) * num_rows * num_cols);
+    struct maze *m = maze_create(num_rows, num_cols);
+    FILE *expected = tmpfile();
+    FILE *actual = tmpfile();
+    int err = 0;
+    if (maze == NULL || encoded == NULL || m == NULL || expected == NULL ||
+        actual == NULL) {
+        fprintf(stderr, "Could not set up case.\n");
+        err = 1;
+        goto done;
+    }
+
+    srand(seed);
+    initialize_maze(num_rows, num_cols, maze);
+    drunken_walk(0, 0, num_rows, num_cols, maze);
+    encode_maze(num_rows, num_cols, maze, encoded);
+    if (maze_generate(m, seed) == 1) {
+        err = 1;
+        goto done;
+    }
+    for (int i = 0; i < num_rows; i++) {
+        for (int j = 0; j < num_cols; j++) {
+            if (maze_room_hex(m, i, j) != (unsigned int)encoded[i][j]) {
+                printf("maze differs at %d, %d\n", i, j);
+                err = 1;
+                goto done;
+            }
+        }
+    }
+
+    // solve the way the solver program does, from the decoded maze
+    initialize_maze(num_rows, num_cols, maze);
+    decode_maze(num_rows, num_cols, maze, encoded);
+    #ifdef FULL
+    fprintf(expected, "FULL\n");
+    fprintf(actual, "FULL\n");
+    dfs(start_row, start_col, goal_row, goal_col, num_rows, num_cols, maze,
+        expected);
+    if (maze_solve(m, start_row, start_col, goal_row, goal_col, actual) < 0) {
+        err = 1;
+        goto done;
+    }
+    #else
+    dfs(start_row, start_col, goal_row, goal_col, num_rows, num_cols, maze,
+        NULL);
+    fprintf(expected, "PRUNED\n");
+    if (print_pruned_path(&maze[start_row][start_col], expected) == 1 ||
+        maze_solve(m, start_row, start_col, goal_row, goal_col, NULL) < 0 ||
+        maze_write_pruned_path(m, start_row, start_col, actual) == 1) {
+        err = 1;
+        goto done;
+    }
+    #endif
+    if (same_contents(expected, actual) == 0) {
+        printf("path differs\n");
+        err = 1;
+    }
+
+done:
+    free(maze);
+    free(encoded);
+    maze_destroy(m);
+    if (expected != NULL) {
+        fclose(expected);
+    }
+    if (actual != NULL) {
+        fclose(actual);
+    }
+    return err;
+}
+
+int main(void) {
+    unsigned int state = 330;
+    for (int i = 0; i < NUM_CASES; i++) {
+        int num_rows = next_case_value(&state, MAX_SIDE) + 1;
+        int num_cols = next_case_value(&state, MAX_SIDE) + 1;
+        int start_row = next_case_value(&state, num_rows);
+        int start_col = next_case_value(&state, num_cols);
+        int goal_row = next_case_value(&state, num_rows);
+        int goal_col = next_case_value(&state, num_cols);
+        if (check_case(num_rows, num_cols, i + 1, start_row, start_col,
+                       goal_row, goal_col) == 1) {
+            printf("case %d failed: %d x %d maze, seed %d, %d, %d -> %d, %d\n",
+                   i, num_rows, num_cols, i + 1, start_row, start_col,
+                   goal_row, goal_col);
+            return 1;
+        }
+    }
+    #ifdef FULL
+    printf("%d cases match the recursive generator and FULL solver\n",
+           NUM_CASES);
+    #else
+    printf("%d cases match the recursive generator and PRUNED solver\n",
+           NUM_CASES);
+    #endif
+    return 0;
+}
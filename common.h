@@ -1,3 +1,6 @@
+#ifndef COMMON_H
+#define COMMON_H
+
 /*
  * Enum to represent the four directions
  * Here is an example of how to use an enum:
@@ -40,3 +43,5 @@ struct maze_room *get_neighbor(int num_rows, int num_cols,
 
 void initialize_maze(int num_rows, int num_cols,
            struct maze_room maze[num_rows][num_cols]);
+
+#endif
@@ -191,6 +191,7 @@ int write_encoded_maze_to_file(int num_rows, int num_cols,
     return 0;
 }
 
+#ifndef MAZE_LIB
 /*
  * Main function
  *
@@ -236,3 +237,4 @@ int main(int argc, char **argv) {
 
     return write_encoded_maze_to_file(num_rows, num_cols, result, file_name);
 }
+#endif
@@ -1,8 +1,11 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
 #include "common.h"
 
 Direction get_opposite_dir(Direction dir);
 
-void shuffle_directions(Direction directions[]);
+void shuffle_array(Direction directions[]);
 
 void drunken_walk(int row, int col, int num_rows, int num_cols,
                   struct maze_room maze[num_rows][num_cols]);
@@ -12,3 +15,9 @@ int encode_room(struct maze_room room);
 void encode_maze(int num_rows, int num_cols,
                  struct maze_room maze[num_rows][num_cols],
                  int result[num_rows][num_cols]);
+
+int write_encoded_maze_to_file(int num_rows, int num_cols,
+                               int encoded_maze[num_rows][num_cols],
+                               char *file_name);
+
+#endif
@@ -0,0 +1,186 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * Seconds elapsed on the monotonic clock
+ */
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * Gets a percentile from sorted latencies
+ *
+ * Parameters:
+ *  - sorted: latencies in ascending order
+ *  - n: number of latencies
+ *  - p: the percentile, between 0 and 100
+ *
+ * Returns:
+ *  - the latency at that percentile
+ */
+static double percentile(double *sorted, int n, double p) {
+    int i = (int)(p / 100 * n + 0.5) - 1;
+    if (i < 0) {
+        i = 0;
+    } else if (i >= n) {
+        i = n - 1;
+    }
+    return sorted[i];
+}
+
+/*
+ * Connects to a solver running with --serve
+ *
+ * Parameters:
+ *  - socket_path: the socket the solver is listening on
+ *
+ * Returns:
+ *  - the connected socket, or -1 if an error occurs
+ */
+static int connect_to_solver(const char *socket_path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Socket path too long.\n");
+        return -1;
+    }
+    strcpy(addr.sun_path, socket_path);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        fprintf(stderr, "Could not connect to %s.\n", socket_path);
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    return fd;
+}
+
+/*
+ * Main function: sends random queries about one maze to a solver running
+ * with --serve, one at a time, and reports the latency of each and the
+ * overall throughput
+ *
+ * Parameters:
+ *  - argc: the number of command line arguments - for this function 6 or 7
+ *  - **argv: a pointer to the first element in the command line
+ *            arguments array - for this function:
+ *            ["maze_loadgen", <socket path>, <maze file>, <number of rows>,
+ *<number of columns>, <number of queries>, [<number of distinct queries>]]
+ *            With fewer distinct queries than queries, the same (start,
+ *goal) pairs are asked about again, which the solver can answer from its
+ *result cache.
+ *
+ * Returns:
+ *  - 0 if program exits correctly, 1 if there is an error
+ */
+int main(int argc, char **argv) {
+    char *socket_path;
+    char *maze_file_name;
+    int num_rows, num_cols, num_queries, num_distinct;
+    if (argc != 6 && argc != 7) {
+        printf("Incorrect number of arguments.\n");
+        printf("./maze_loadgen <socket path> <maze file> <number of rows>");
+        printf(" <number of columns> <number of queries>");
+        printf(" [<number of distinct queries>]\n");
+        return 1;
+    } else {
+        socket_path = argv[1];
+        maze_file_name = argv[2];
+        num_rows = atoi(argv[3]);
+        num_cols = atoi(argv[4]);
+        num_queries = atoi(argv[5]);
+        num_distinct = argc == 7 ? atoi(argv[6]) : num_queries;
+    }
+    if ((num_rows <= 0) || (num_cols <= 0) || (num_queries <= 0) ||
+        (num_distinct <= 0)) {
+        return 1;
+    }
+
+    int fd = connect_to_solver(socket_path);
+    if (fd < 0) {
+        return 1;
+    }
+    FILE *in = fdopen(fd, "r");
+    FILE *out = fdopen(dup(fd), "w");
+    int *queries = malloc(4 * sizeof(int) * (size_t)num_distinct);
+    double *latencies = malloc(sizeof(double) * (size_t)num_queries);
+    if (in == NULL || out == NULL || queries == NULL || latencies == NULL) {
+        fprintf(stderr, "Could not set up queries.\n");
+        return 1;
+    }
+
+    srand(time(NULL));
+    for (int i = 0; i < 4 * num_distinct; i += 2) {
+        queries[i] = rand() % num_rows;
+        queries[i + 1] = rand() % num_cols;
+    }
+
+    char *line = NULL;
+    size_t cap = 0;
+    int errors = 0;
+    long path_rooms = 0;
+    double start = now();
+    for (int i = 0; i < num_queries; i++) {
+        int *q = &queries[4 * (rand() % num_distinct)];
+        double sent = now();
+        fprintf(out, "%s %d %d %d %d %d %d\n", maze_file_name, num_rows,
+                num_cols, q[0], q[1], q[2], q[3]);
+        if (fflush(out) == EOF) {
+            fprintf(stderr, "Error sending query.\n");
+            return 1;
+        }
+        // read the response up to the empty line that ends it
+        int first = 1;
+        for (;;) {
+            if (getline(&line, &cap, in) == -1) {
+                fprintf(stderr, "Connection closed by solver.\n");
+                return 1;
+            }
+            if (line[0] == '\n') {
+                break;
+            }
+            if (first == 1 && strncmp(line, "ERROR", 5) == 0) {
+                errors++;
+            } else if (first == 0) {
+                path_rooms++;
+            }
+            first = 0;
+        }
+        latencies[i] = now() - sent;
+    }
+    double elapsed = now() - start;
+
+    qsort(latencies, num_queries, sizeof(double), compare_doubles);
+    printf("%d queries (%d distinct) in %.3f s: %.1f queries/sec\n",
+           num_queries, num_distinct, elapsed, num_queries / elapsed);
+    printf("latency p50 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+           1e3 * percentile(latencies, num_queries, 50),
+           1e3 * percentile(latencies, num_queries, 99),
+           1e3 * latencies[num_queries - 1]);
+    printf("%ld rooms on paths, %d errors\n", path_rooms, errors);
+
+    free(line);
+    free(queries);
+    free(latencies);
+    fclose(in);
+    fclose(out);
+    return errors > 0;
+}
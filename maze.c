@@ -0,0 +1,650 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "generator.h"
+#include "maze.h"
+#include "solver.h"
+
+/*
+ * A maze owned by the library. The rooms are stored row-major in a single
+ * allocation so they can be viewed as a num_rows x num_cols array and handed
+ * to the functions in common.c, generator.c and solver.c.
+ */
+struct maze {
+    int num_rows;
+    int num_cols;
+    struct maze_room *rooms;
+};
+
+/*
+ * Views the rooms of m as a 2D array with m->num_cols columns
+ */
+#define MAZE_GRID(m) ((struct maze_room(*)[(m)->num_cols])(m)->rooms)
+
+/*
+ * A frame of the explicit stack used by the generator and solver below. The
+ * recursive drunken_walk and dfs go one call deep per room on the path, which
+ * overflows the call stack long before the grid itself stops fitting in
+ * memory, so the library walks with a heap-allocated stack instead.
+ *
+ *  - row, col: the room this frame is visiting
+ *  - order: the four directions to try, two bits each, first in the low bits
+ *  - next_dir: how many of those directions have been tried already
+ */
+struct walk_frame {
+    int row;
+    int col;
+    unsigned char order;
+    unsigned char next_dir;
+};
+
+struct walk_stack {
+    struct walk_frame *frames;
+    size_t size;
+    size_t capacity;
+};
+
+/*
+ * Pushes a frame onto the stack, growing it if necessary
+ *
+ * Parameters:
+ *  - stack: the stack to push onto
+ *  - row: row of the room to visit
+ *  - col: column of the room to visit
+ *  - order: the packed order of the directions to try from this room
+ *
+ * Returns:
+ *  - 1 if an error occurs, 0 otherwise
+ */
+static int push_frame(struct walk_stack *stack, int row, int col,
+                      unsigned char order) {
+    if (stack->size == stack->capacity) {
+        size_t capacity = stack->capacity == 0 ? 1024 : 2 * stack->capacity;
+        struct walk_frame *frames =
+            realloc(stack->frames, capacity * sizeof(struct walk_frame));
+        if (frames == NULL) {
+            fprintf(stderr, "Could not allocate walk stack.\n");
+            return 1;
+        }
+        stack->frames = frames;
+        stack->capacity = capacity;
+    }
+    struct walk_frame *f = &stack->frames[stack->size++];
+    f->row = row;
+    f->col = col;
+    f->order = order;
+    f->next_dir = 0;
+    return 0;
+}
+
+/*
+ * Packs four directions into a single byte, two bits each
+ *
+ * Parameters:
+ *  - directions: an array of Direction enums of size 4
+ *
+ * Returns:
+ *  - the packed directions, directions[0] in the lowest bits
+ */
+static unsigned char pack_directions(Direction directions[]) {
+    return (unsigned char)(directions[0] | directions[1] << 2 |
+                           directions[2] << 4 | directions[3] << 6);
+}
+
+/*
+ * Allocates a maze with the given dimensions. Every room is initialized as in
+ * initialize_maze and then walled in on all four sides, so a new maze can be
+ * solved or written out before anything is generated or read into it.
+ *
+ * Parameters:
+ *  - num_rows: number of rows in the maze
+ *  - num_cols: number of columns in the maze
+ *
+ * Returns:
+ *  - the new maze, or NULL if the dimensions are invalid or memory runs out
+ */
+struct maze *maze_create(int num_rows, int num_cols) {
+    if ((num_rows <= 0) || (num_cols <= 0)) {
+        return NULL;
+    }
+    size_t bytes = maze_size_bytes(num_rows, num_cols);
+    if (bytes == 0) {
+        return NULL;
+    }
+    struct maze *m = malloc(sizeof(struct maze));
+    if (m == NULL) {
+        return NULL;
+    }
+    m->rooms = malloc(bytes);
+    if (m->rooms == NULL) {
+        free(m);
+        return NULL;
+    }
+    m->num_rows = num_rows;
+    m->num_cols = num_cols;
+    initialize_maze(num_rows, num_cols, MAZE_GRID(m));
+    size_t cells = (size_t)num_rows * (size_t)num_cols;
+    for (size_t i = 0; i < cells; i++) {
+        for (int k = 0; k < 4; k++) {
+            m->rooms[i].dirs[k] = 1;
+        }
+        m->rooms[i].next = NULL;
+    }
+    return m;
+}
+
+/*
+ * Frees a maze created by maze_create. Does nothing if m is NULL.
+ *
+ * Parameters:
+ *  - m: the maze to free
+ *
+ * Returns:
+ *  - nothing
+ */
+void maze_destroy(struct maze *m) {
+    if (m == NULL) {
+        return;
+    }
+    free(m->rooms);
+    free(m);
+}
+
+int maze_num_rows(const struct maze *m) {
+    return m->num_rows;
+}
+
+int maze_num_cols(const struct maze *m) {
+    return m->num_cols;
+}
+
+/*
+ * Computes how much memory the rooms of a maze with the given dimensions
+ * take up
+ *
+ * Parameters:
+ *  - num_rows: number of rows in the maze
+ *  - num_cols: number of columns in the maze
+ *
+ * Returns:
+ *  - the size of the grid in bytes, or 0 if it does not fit in a size_t
+ */
+size_t maze_size_bytes(int num_rows, int num_cols) {
+    if ((num_rows <= 0) || (num_cols <= 0)) {
+        return 0;
+    }
+    size_t cells = (size_t)num_rows * (size_t)num_cols;
+    if (cells / (size_t)num_rows != (size_t)num_cols ||
+        cells > SIZE_MAX / sizeof(struct maze_room)) {
+        return 0;
+    }
+    return cells * sizeof(struct maze_room);
+}
+
+/*
+ * Gets the hex encoding (see encode_room) of a single room
+ *
+ * Parameters:
+ *  - m: the maze
+ *  - row: row of the room
+ *  - col: column of the room
+ *
+ * Returns:
+ *  - the integer representation of the room, between 0 and 15, or more than
+ *    15 if one of its connections is unset (see initialize_maze)
+ */
+unsigned int maze_room_hex(const struct maze *m, int row, int col) {
+    return (unsigned int)encode_room(
+        m->rooms[(size_t)row * (size_t)m->num_cols + (size_t)col]);
+}
+
+/*
+ * Generates a new maze in m using the same drunken walk as the generator,
+ * starting from the room in the top left corner. For a given seed, this
+ * produces exactly the maze the recursive drunken_walk would.
+ *
+ * Parameters:
+ *  - m: the maze to generate (any previous contents are discarded)
+ *  - seed: the value passed to srand before walking
+ *
+ * Returns:
+ *  - 1 if the walk stack cannot be allocated, 0 otherwise
+ */
+int maze_generate(struct maze *m, unsigned int seed) {
+    int num_rows = m->num_rows;
+    int num_cols = m->num_cols;
+    struct maze_room(*maze)[num_cols] = MAZE_GRID(m);
+    struct walk_stack stack = {NULL, 0, 0};
+
+    initialize_maze(num_rows, num_cols, maze);
+    srand(seed);
+
+    Direction directions[4] = {NORTH, SOUTH, WEST, EAST};
+    shuffle_array(directions);
+    maze[0][0].visited = 1;
+    if (push_frame(&stack, 0, 0, pack_directions(directions)) == 1) {
+        return 1;
+    }
+
+    while (stack.size > 0) {
+        struct walk_frame *f = &stack.frames[stack.size - 1];
+        if (f->next_dir == 4) {
+            stack.size--;
+            continue;
+        }
+        Direction dir = (f->order >> (2 * f->next_dir)) & 3;
+        f->next_dir++;
+
+        struct maze_room *r = &maze[f->row][f->col];
+        struct maze_room *n = get_neighbor(num_rows, num_cols, maze, r, dir);
+        if (n == NULL) {
+            r->dirs[dir] = 1;
+        } else if (n->visited == 0) {
+            r->dirs[dir] = 0;
+            Direction n_directions[4] = {NORTH, SOUTH, WEST, EAST};
+            shuffle_array(n_directions);
+            n->visited = 1;
+            if (push_frame(&stack, n->row, n->col,
+                           pack_directions(n_directions)) == 1) {
+                free(stack.frames);
+                return 1;
+            }
+        } else if (n->dirs[get_opposite_dir(dir)] != 1000) {
+            r->dirs[dir] = n->dirs[get_opposite_dir(dir)];
+        } else {
+            r->dirs[dir] = 1;
+        }
+    }
+    free(stack.frames);
+    return 0;
+}
+
+/*
+ * Writes a room's coordinates to the FULL trace, if there is one
+ *
+ * Parameters:
+ *  - room: the room being visited
+ *  - full: the file to write to, or NULL
+ *
+ * Returns:
+ *  - 1 if an error occurs, 0 otherwise
+ */
+static int trace_room(struct maze_room *room, FILE *full) {
+    if (full == NULL) {
+        return 0;
+    }
+    if (fprintf(full, "%d, %d\n", room->row, room->col) < 0) {
+        fprintf(stderr, "Error printing to file.\n");
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * Solves m with the same depth-first search as the solver, leaving the
+ * pruned solution in the rooms' next pointers (see maze_write_pruned_path).
+ * Any earlier solution is cleared first, so a maze can be solved any number
+ * of times, including straight after maze_generate.
+ *
+ * Parameters:
+ *  - m: the maze to solve
+ *  - start_row, start_col: the room to start from
+ *  - goal_row, goal_col: the room to find
+ *  - full: if not NULL, every room visited is written here in the order the
+ *    FULL solver would write it (the "FULL" header is left to the caller)
+ *
+ * Returns:
+ *  - 1 if a path was found, 0 if there is none, -1 if an error occurs
+ */
+int maze_solve(struct maze *m, int start_row, int start_col, int goal_row,
+               int goal_col, FILE *full) {
+    int num_rows = m->num_rows;
+    int num_cols = m->num_cols;
+    struct maze_room(*maze)[num_cols] = MAZE_GRID(m);
+    Direction directions[4] = {NORTH, SOUTH, WEST, EAST};
+    unsigned char order = pack_directions(directions);
+    struct walk_stack stack = {NULL, 0, 0};
+    int found = 0;
+
+    if ((is_in_range(start_row, start_col, num_rows, num_cols) == 0) ||
+        (is_in_range(goal_row, goal_col, num_rows, num_cols) == 0)) {
+        return -1;
+    }
+    size_t cells = (size_t)num_rows * (size_t)num_cols;
+    for (size_t i = 0; i < cells; i++) {
+        m->rooms[i].visited = 0;
+        m->rooms[i].next = NULL;
+    }
+
+    struct maze_room *start = &maze[start_row][start_col];
+    if (trace_room(start, full) == 1) {
+        return -1;
+    }
+    if ((start_row == goal_row) && (start_col == goal_col)) {
+        return 1;
+    }
+    start->visited = 1;
+    if (push_frame(&stack, start_row, start_col, order) == 1) {
+        return -1;
+    }
+
+    while (stack.size > 0 && found == 0) {
+        struct walk_frame *f = &stack.frames[stack.size - 1];
+        struct maze_room *room = &maze[f->row][f->col];
+        if (f->next_dir == 4) {
+            // dead end: the parent writes itself again when backtracking
+            stack.size--;
+            if (stack.size > 0) {
+                f = &stack.frames[stack.size - 1];
+                if (trace_room(&maze[f->row][f->col], full) == 1) {
+                    found = -1;
+                }
+            }
+            continue;
+        }
+        Direction dir = directions[f->next_dir];
+        f->next_dir++;
+        if (room->dirs[dir] != 0) {
+            continue;
+        }
+        struct maze_room *n = get_neighbor(num_rows, num_cols, maze, room, dir);
+        if (n == NULL || n->visited != 0) {
+            continue;
+        }
+        if (trace_room(n, full) == 1) {
+            found = -1;
+        } else if ((n->row == goal_row) && (n->col == goal_col)) {
+            // link the rooms on the stack into the pruned path
+            n->next = NULL;
+            for (size_t i = stack.size; i > 0; i--) {
+                struct walk_frame *p = &stack.frames[i - 1];
+                maze[p->row][p->col].next = n;
+                n = &maze[p->row][p->col];
+            }
+            found = 1;
+        } else {
+            n->visited = 1;
+            if (push_frame(&stack, n->row, n->col, order) == 1) {
+                found = -1;
+            }
+        }
+    }
+    free(stack.frames);
+    return found;
+}
+
+/*
+ * Fused generate-and-solve: generates a maze in m and solves it in place,
+ * with no encoding or decoding in between
+ *
+ * Parameters:
+ *  - see maze_generate and maze_solve
+ *
+ * Returns:
+ *  - -1 if generating fails, otherwise the result of maze_solve
+ */
+int maze_generate_and_solve(struct maze *m, unsigned int seed, int start_row,
+                            int start_col, int goal_row, int goal_col,
+                            FILE *full) {
+    if (maze_generate(m, seed) == 1) {
+        return -1;
+    }
+    return maze_solve(m, start_row, start_col, goal_row, goal_col, full);
+}
+
+/*
+ * Writes the pruned solution found by the last maze_solve, in the format of
+ * the PRUNED solver (including the "PRUNED" header)
+ *
+ * Parameters:
+ *  - m: a solved maze
+ *  - start_row, start_col: the room the maze was solved from
+ *  - file: the file to write the path to
+ *
+ * Returns:
+ *  - 1 if an error occurs, 0 otherwise
+ */
+int maze_write_pruned_path(const struct maze *m, int start_row, int start_col,
+                           FILE *file) {
+    if (is_in_range(start_row, start_col, m->num_rows, m->num_cols) == 0) {
+        return 1;
+    }
+    if (fprintf(file, "PRUNED\n") < 0) {
+        fprintf(stderr, "Error printing to file.\n");
+        return 1;
+    }
+    return print_pruned_path(&MAZE_GRID(m)[start_row][start_col], file);
+}
+
+/*
+ * Number of bytes a row of num_cols rooms takes up in the given format,
+ * including the newline for MAZE_HEX
+ */
+static size_t row_bytes(int num_cols, maze_format format) {
+    if (format == MAZE_PACKED) {
+        return ((size_t)num_cols + 1) / 2;
+    }
+    return (size_t)num_cols + 1;
+}
+
+/*
+ * Writes m to an open file in the given format
+ *
+ * Parameters:
+ *  - m: the maze to write
+ *  - file: the file to write to
+ *  - format: MAZE_HEX or MAZE_PACKED
+ *
+ * Returns:
+ *  - 1 if an error occurs, 0 otherwise
+ */
+int maze_write(const struct maze *m, FILE *file, maze_format format) {
+    static const char hex_digits[] = "0123456789abcdef";
+    size_t len = row_bytes(m->num_cols, format);
+    unsigned char *line = malloc(len);
+    if (line == NULL) {
+        fprintf(stderr, "Could not allocate row buffer.\n");
+        return 1;
+    }
+    for (int i = 0; i < m->num_rows; i++) {
+        if (format == MAZE_PACKED) {
+            memset(line, 0, len);
+        } else {
+            line[m->num_cols] = '\n';
+        }
+        for (int j = 0; j < m->num_cols; j++) {
+            unsigned int hex = maze_room_hex(m, i, j);
+            if (hex > 15) {
+                // a connection is neither a wall nor an opening
+                fprintf(stderr, "Room %d, %d has unset connections.\n", i, j);
+                free(line);
+                return 1;
+            }
+            if (format == MAZE_PACKED) {
+                line[j / 2] |= hex << (4 * (j % 2));
+            } else {
+                line[j] = hex_digits[hex];
+            }
+        }
+        if (fwrite(line, 1, len, file) != len) {
+            fprintf(stderr, "Writing to file failed.\n");
+            free(line);
+            return 1;
+        }
+    }
+    free(line);
+    return 0;
+}
+
+/*
+ * Reads the next room from a hex file, skipping whitespace as fscanf's %1x
+ * would
+ *
+ * Parameters:
+ *  - file: the file to read from
+ *
+ * Returns:
+ *  - the room's value between 0 and 15, or -1 on end of file or a character
+ *    that is not a hex digit
+ */
+static int read_hex_room(FILE *file) {
+    int c;
+    do {
+        c = getc(file);
+    } while (c == '\n' || c == '\r' || c == ' ' || c == '\t');
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+/*
+ * Reads the next row of a maze from an open file without decoding it, so
+ * that mazes too big to hold in memory can be streamed a row at a time
+ *
+ * Parameters:
+ *  - file: the file to read from
+ *  - num_cols: number of columns in the maze
+ *  - format: MAZE_HEX or MAZE_PACKED
+ *  - hex: where to store the row, one value between 0 and 15 per room (see
+ *    create_room_connections for what the bits mean)
+ *
+ * Returns:
+ *  - 1 if an error occurs, 0 otherwise
+ */
+int maze_read_row(FILE *file, int num_cols, maze_format format,
+                  unsigned char *hex) {
+    if (format == MAZE_PACKED) {
+        size_t len = row_bytes(num_cols, format);
+        if (fread(hex, 1, len, file) != len) {
+            fprintf(stderr, "Reading from file failed.\n");
+            return 1;
+        }
+        // unpack in place, back to front so no byte is overwritten before
+        // both of its rooms have been read out of it
+        for (int j = num_cols - 1; j >= 0; j--) {
+            hex[j] = (hex[j / 2] >> (4 * (j % 2))) & 0xf;
+        }
+        return 0;
+    }
+    for (int j = 0; j < num_cols; j++) {
+        int room = read_hex_room(file);
+        if (room < 0) {
+            fprintf(stderr, "Reading from file failed.\n");
+            return 1;
+        }
+        hex[j] = (unsigned char)room;
+    }
+    return 0;
+}
+
+/*
+ * Reads a maze with m's dimensions from an open file, decoding each room as
+ * create_room_connections does
+ *
+ * Parameters:
+ *  - m: the maze to read into
+ *  - file: the file to read from
+ *  - format: MAZE_HEX or MAZE_PACKED
+ *
+ * Returns:
+ *  - 1 if an error occurs, 0 otherwise
+ */
+int maze_read(struct maze *m, FILE *file, maze_format format) {
+    struct maze_room(*maze)[m->num_cols] = MAZE_GRID(m);
+    unsigned char *line = malloc((size_t)m->num_cols);
+    if (line == NULL) {
+        fprintf(stderr, "Could not allocate row buffer.\n");
+        return 1;
+    }
+    for (int i = 0; i < m->num_rows; i++) {
+        if (maze_read_row(file, m->num_cols, format, line) == 1) {
+            free(line);
+            return 1;
+        }
+        for (int j = 0; j < m->num_cols; j++) {
+            maze[i][j].row = i;
+            maze[i][j].col = j;
+            maze[i][j].visited = 0;
+            maze[i][j].next = NULL;
+            create_room_connections(&maze[i][j], line[j]);
+        }
+    }
+    free(line);
+    return 0;
+}
+
+/*
+ * Writes m to the named file (created if necessary)
+ *
+ * Parameters:
+ *  - m: the maze to write
+ *  - file_name: the name of the output file
+ *  - format: MAZE_HEX or MAZE_PACKED
+ *
+ * Returns:
+ *  - 1 if an error occurs, 0 otherwise
+ */
+int maze_save(const struct maze *m, const char *file_name, maze_format format) {
+    FILE *f = fopen(file_name, format == MAZE_PACKED ? "wb" : "w");
+    if (f == NULL) {
+        fprintf(stderr, "Error opening file.\n");
+        return 1;
+    }
+    int err = maze_write(m, f, format);
+    if (fclose(f) == EOF) {
+        fprintf(stderr, "Could not close file.\n");
+        return 1;
+    }
+    return err;
+}
+
+/*
+ * Reads a maze with m's dimensions from the named file
+ *
+ * Parameters:
+ *  - m: the maze to read into
+ *  - file_name: the name of the input file
+ *  - format: MAZE_HEX or MAZE_PACKED
+ *
+ * Returns:
+ *  - 1 if an error occurs, 0 otherwise
+ */
+int maze_load(struct maze *m, const char *file_name, maze_format format) {
+    FILE *f = fopen(file_name, format == MAZE_PACKED ? "rb" : "r");
+    if (f == NULL) {
+        fprintf(stderr, "Error opening file.\n");
+        return 1;
+    }
+    int err = maze_read(m, f, format);
+    if (fclose(f) == EOF) {
+        fprintf(stderr, "Could not close file.\n");
+        return 1;
+    }
+    return err;
+}
+
+/*
+ * Picks a format from a file name: files ending in ".mzp" are MAZE_PACKED,
+ * everything else is MAZE_HEX
+ *
+ * Parameters:
+ *  - file_name: the name of the maze file
+ *
+ * Returns:
+ *  - the format to read or write the file in
+ */
+maze_format maze_format_for_path(const char *file_name) {
+    size_t len = strlen(file_name);
+    if (len >= 4 && strcmp(file_name + len - 4, ".mzp") == 0) {
+        return MAZE_PACKED;
+    }
+    return MAZE_HEX;
+}
@@ -0,0 +1,72 @@
+#ifndef MAZE_H
+#define MAZE_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * libmaze: an in-process interface to the generator and solver.
+ *
+ * A struct maze owns a heap-allocated num_rows x num_cols grid of rooms, so
+ * a maze can be generated, solved and serialized without going through the
+ * hex text files that the generator and solver programs use to talk to each
+ * other. Unless stated otherwise, functions returning int return 1 if an
+ * error occurs and 0 otherwise.
+ */
+struct maze;
+
+/*
+ * On-disk formats for a maze:
+ *  - MAZE_HEX: one hex digit per room, one line per row (what the generator
+ *    writes and the solver reads)
+ *  - MAZE_PACKED: two rooms per byte, low nibble first, each row padded to a
+ *    whole number of bytes
+ */
+typedef enum { MAZE_HEX = 0, MAZE_PACKED = 1 } maze_format;
+
+struct maze *maze_create(int num_rows, int num_cols);
+
+void maze_destroy(struct maze *m);
+
+int maze_num_rows(const struct maze *m);
+
+int maze_num_cols(const struct maze *m);
+
+size_t maze_size_bytes(int num_rows, int num_cols);
+
+unsigned int maze_room_hex(const struct maze *m, int row, int col);
+
+int maze_generate(struct maze *m, unsigned int seed);
+
+int maze_solve(struct maze *m, int start_row, int start_col, int goal_row,
+               int goal_col, FILE *full);
+
+int maze_generate_and_solve(struct maze *m, unsigned int seed, int start_row,
+                            int start_col, int goal_row, int goal_col,
+                            FILE *full);
+
+int maze_write_pruned_path(const struct maze *m, int start_row, int start_col,
+                           FILE *file);
+
+int maze_write(const struct maze *m, FILE *file, maze_format format);
+
+int maze_read(struct maze *m, FILE *file, maze_format format);
+
+int maze_read_row(FILE *file, int num_cols, maze_format format,
+                  unsigned char *hex);
+
+int maze_save(const struct maze *m, const char *file_name, maze_format format);
+
+int maze_load(struct maze *m, const char *file_name, maze_format format);
+
+maze_format maze_format_for_path(const char *file_name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
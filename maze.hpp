@@ -0,0 +1,105 @@
+#ifndef MAZE_HPP
+#define MAZE_HPP
+
+#include <cstdio>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "maze.h"
+
+namespace libmaze {
+
+/*
+ * Owning, move-only handle to a struct maze. The grid is never copied:
+ * moving a Maze hands over the pointer and leaves the source empty.
+ * Errors reported by the C library are thrown as std::runtime_error.
+ */
+class Maze {
+  public:
+    Maze(int num_rows, int num_cols) : m_(maze_create(num_rows, num_cols)) {
+        if (m_ == nullptr) {
+            if (maze_size_bytes(num_rows, num_cols) == 0) {
+                throw std::invalid_argument("invalid maze dimensions");
+            }
+            throw std::bad_alloc();
+        }
+    }
+
+    ~Maze() { maze_destroy(m_); }
+
+    Maze(const Maze &) = delete;
+    Maze &operator=(const Maze &) = delete;
+
+    Maze(Maze &&other) noexcept : m_(other.m_) { other.m_ = nullptr; }
+
+    Maze &operator=(Maze &&other) noexcept {
+        if (this != &other) {
+            maze_destroy(m_);
+            m_ = other.m_;
+            other.m_ = nullptr;
+        }
+        return *this;
+    }
+
+    static Maze load(const std::string &file_name, int num_rows, int num_cols) {
+        Maze maze(num_rows, num_cols);
+        if (maze_load(maze.m_, file_name.c_str(),
+                      maze_format_for_path(file_name.c_str())) == 1) {
+            throw std::runtime_error("could not read maze from " + file_name);
+        }
+        return maze;
+    }
+
+    void save(const std::string &file_name) const {
+        if (maze_save(m_, file_name.c_str(),
+                      maze_format_for_path(file_name.c_str())) == 1) {
+            throw std::runtime_error("could not write maze to " + file_name);
+        }
+    }
+
+    int num_rows() const { return maze_num_rows(m_); }
+    int num_cols() const { return maze_num_cols(m_); }
+
+    void generate(unsigned int seed) {
+        if (maze_generate(m_, seed) == 1) {
+            throw std::runtime_error("could not generate maze");
+        }
+    }
+
+    // Returns whether a path was found; the FULL trace goes to full if set.
+    bool solve(int start_row, int start_col, int goal_row, int goal_col,
+               std::FILE *full = nullptr) {
+        int found = maze_solve(m_, start_row, start_col, goal_row, goal_col,
+                               full);
+        if (found < 0) {
+            throw std::runtime_error("could not solve maze");
+        }
+        return found == 1;
+    }
+
+    bool generate_and_solve(unsigned int seed, int start_row, int start_col,
+                            int goal_row, int goal_col,
+                            std::FILE *full = nullptr) {
+        generate(seed);
+        return solve(start_row, start_col, goal_row, goal_col, full);
+    }
+
+    void write_pruned_path(int start_row, int start_col,
+                           std::FILE *file) const {
+        if (maze_write_pruned_path(m_, start_row, start_col, file) == 1) {
+            throw std::runtime_error("could not write path");
+        }
+    }
+
+    struct maze *get() { return m_; }
+    const struct maze *get() const { return m_; }
+
+  private:
+    struct maze *m_;
+};
+
+} // namespace libmaze
+
+#endif
@@ -0,0 +1,76 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "maze.h"
+
+/*
+ * Main function: generates a maze and solves it in memory, without writing
+ * the maze out and reading it back in between
+ *
+ * Parameters:
+ *  - argc: the number of command line arguments - for this function 8 or 9
+ *  - **argv: a pointer to the first element in the command line
+ *            arguments array - for this function:
+ *            ["pipeline", <output path file>, <number of rows>, <number of
+ *columns>, <starting row>, <starting column>, <ending row>, <ending column>,
+ *[<output maze file>]]
+ *
+ * Returns:
+ *  - 0 if program exits correctly, 1 if there is an error
+ */
+int main(int argc, char **argv) {
+    int num_rows, num_cols, start_row, start_col, goal_row, goal_col;
+    char *path_file_name;
+    char *maze_file_name = NULL;
+    if (argc != 8 && argc != 9) {
+        printf("Incorrect number of arguments.\n");
+        printf("./pipeline <output path file> <number of rows>");
+        printf(" <number of columns> <starting row> <starting column>");
+        printf(" <ending row> <ending column> [<output maze file>]\n");
+        return 1;
+    } else {
+        path_file_name = argv[1];
+        num_rows = atoi(argv[2]);
+        num_cols = atoi(argv[3]);
+        start_row = atoi(argv[4]);
+        start_col = atoi(argv[5]);
+        goal_row = atoi(argv[6]);
+        goal_col = atoi(argv[7]);
+        if (argc == 9) {
+            maze_file_name = argv[8];
+        }
+    }
+
+    struct maze *m = maze_create(num_rows, num_cols);
+    if (m == NULL) {
+        fprintf(stderr, "Could not create maze.\n");
+        return 1;
+    }
+    if (maze_generate_and_solve(m, time(NULL), start_row, start_col, goal_row,
+                                goal_col, NULL) < 0) {
+        maze_destroy(m);
+        return 1;
+    }
+
+    if (maze_file_name != NULL &&
+        maze_save(m, maze_file_name, maze_format_for_path(maze_file_name)) ==
+            1) {
+        maze_destroy(m);
+        return 1;
+    }
+
+    FILE *opened_file = fopen(path_file_name, "w");
+    if (opened_file == NULL) {
+        fprintf(stderr, "Error opening file.\n");
+        maze_destroy(m);
+        return 1;
+    }
+    int err = maze_write_pruned_path(m, start_row, start_col, opened_file);
+    maze_destroy(m);
+    if (fclose(opened_file) == EOF) {
+        fprintf(stderr, "Error closing file.\n");
+        return 1;
+    }
+    return err;
+}
@@ -0,0 +1,270 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "maze.h"
+
+/*
+ * Checks the renderer against a render of the whole image done here in
+ * memory: level 0 and level 1 of a maze several tiles across, with and
+ * without a path overlay. The maze and path are made with libmaze, and the
+ * expected image follows the rules in renderer.c's header comment rather
+ * than its code: rooms and the gaps between connected rooms are open, a
+ * level is the 2x2 average (rounded) of the one below, and a pixel is on the
+ * path at a level if any pixel it comes from is.
+ */
+
+#define NUM_ROWS 300
+#define NUM_COLS 700
+#define TILE_SIZE 512
+
+static char dir[] = "/tmp/render_check_XXXXXX";
+
+/*
+ * One level of the expected image
+ */
+struct image {
+    int width;
+    int height;
+    unsigned char *gray;
+    unsigned char *path;
+};
+
+static int alloc_image(struct image *im, int width, int height) {
+    im->width = width;
+    im->height = height;
+    im->gray = calloc((size_t)width * height, 1);
+    im->path = calloc((size_t)width * height, 1);
+    return im->gray == NULL || im->path == NULL;
+}
+
+static void free_image(struct image *im) {
+    free(im->gray);
+    free(im->path);
+}
+
+/*
+ * Draws a maze at level 0: every room open, and the gap on each side of a
+ * room open unless the room has a wall there
+ */
+static void draw_maze(struct maze *m, struct image *im) {
+    for (int row = 0; row < NUM_ROWS; row++) {
+        for (int col = 0; col < NUM_COLS; col++) {
+            unsigned int hex = maze_room_hex(m, row, col);
+            int y = 2 * row + 1;
+            int x = 2 * col + 1;
+            im->gray[(size_t)y * im->width + x] = 255;
+            im->gray[(size_t)(y - 1) * im->width + x] = hex & 1 ? 0 : 255;
+            im->gray[(size_t)(y + 1) * im->width + x] = hex & 2 ? 0 : 255;
+            im->gray[(size_t)y * im->width + x - 1] = hex & 4 ? 0 : 255;
+            im->gray[(size_t)y * im->width + x + 1] = hex & 8 ? 0 : 255;
+        }
+    }
+}
+
+/*
+ * Marks a path file's rooms at level 0, and the gap between each pair of
+ * neighbouring rooms that follow each other in it
+ *
+ * Returns:
+ *  - the number of rooms on the path, or -1 if an error occurs
+ */
+static int draw_path(const char *file_name, struct image *im) {
+    FILE *f = fopen(file_name, "r");
+    if (f == NULL || fscanf(f, "PRUNED") != 0) {
+        return -1;
+    }
+    int row, col, prev_row = -1, prev_col = -1, rooms = 0;
+    while (fscanf(f, "%d, %d", &row, &col) == 2) {
+        im->path[(size_t)(2 * row + 1) * im->width + 2 * col + 1] = 1;
+        if (abs(row - prev_row) + abs(col - prev_col) == 1) {
+            im->path[(size_t)(row + prev_row + 1) * im->width + col +
+                     prev_col + 1] = 1;
+        }
+        prev_row = row;
+        prev_col = col;
+        rooms++;
+    }
+    fclose(f);
+    return rooms;
+}
+
+/*
+ * Halves a level in each direction
+ */
+static int shrink(const struct image *src, struct image *dst) {
+    if (alloc_image(dst, (src->width + 1) / 2, (src->height + 1) / 2) == 1) {
+        return 1;
+    }
+    for (int y = 0; y < dst->height; y++) {
+        for (int x = 0; x < dst->width; x++) {
+            int sum = 0, on_path = 0;
+            for (int dy = 0; dy < 2; dy++) {
+                for (int dx = 0; dx < 2; dx++) {
+                    // the last row or column stands in for a missing one
+                    int sy = 2 * y + dy < src->height ? 2 * y + dy : 2 * y;
+                    int sx = 2 * x + dx < src->width ? 2 * x + dx : 2 * x;
+                    size_t i = (size_t)sy * src->width + sx;
+                    sum += src->gray[i];
+                    on_path |= src->path[i];
+                }
+            }
+            dst->gray[(size_t)y * dst->width + x] = (sum + 2) / 4;
+            dst->path[(size_t)y * dst->width + x] = on_path;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Compares the tiles the renderer wrote for a level with the expected image
+ *
+ * Parameters:
+ *  - out_dir: the renderer's output directory
+ *  - level: the level to compare
+ *  - im: the expected image of the level
+ *  - overlay: whether the tiles should be PPMs with the path painted on
+ *
+ * Returns:
+ *  - 1 if a tile differs or is missing, 0 otherwise
+ */
+static int check_level(const char *out_dir, int level, const struct image *im,
+                       int overlay) {
+    for (int y0 = 0; y0 < im->height; y0 += TILE_SIZE) {
+        for (int x0 = 0; x0 < im->width; x0 += TILE_SIZE) {
+            char file_name[256];
+            snprintf(file_name, sizeof(file_name), "%s/%d/%d_%d.%s", out_dir,
+                     level, y0 / TILE_SIZE, x0 / TILE_SIZE,
+                     overlay ? "ppm" : "pgm");
+            int width = im->width - x0 < TILE_SIZE ? im->width - x0 : TILE_SIZE;
+            int height =
+                im->height - y0 < TILE_SIZE ? im->height - y0 : TILE_SIZE;
+            FILE *f = fopen(file_name, "rb");
+            char magic[3];
+            int tile_width, tile_height, max;
+            if (f == NULL ||
+                fscanf(f, "%2s %d %d %d", magic, &tile_width, &tile_height,
+                       &max) != 4 ||
+                strcmp(magic, overlay ? "P6" : "P5") != 0 ||
+                tile_width != width || tile_height != height || max != 255 ||
+                getc(f) != '\n') {
+                printf("%s: missing or wrong header\n", file_name);
+                if (f != NULL) {
+                    fclose(f);
+                }
+                return 1;
+            }
+            for (int y = y0; y < y0 + height; y++) {
+                for (int x = x0; x < x0 + width; x++) {
+                    size_t i = (size_t)y * im->width + x;
+                    int expected[3] = {im->gray[i], im->gray[i], im->gray[i]};
+                    if (overlay && im->path[i]) {
+                        expected[0] = 255;
+                        expected[1] = 0;
+                        expected[2] = 0;
+                    }
+                    for (int c = 0; c < (overlay ? 3 : 1); c++) {
+                        int actual = getc(f);
+                        if (actual != expected[c]) {
+                            printf("%s: pixel %d, %d is %d, expected %d\n",
+                                   file_name, y, x, actual, expected[c]);
+                            fclose(f);
+                            return 1;
+                        }
+                    }
+                }
+            }
+            int extra = getc(f);
+            fclose(f);
+            if (extra != EOF) {
+                printf("%s: longer than expected\n", file_name);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/*
+ * Runs the renderer and compares levels 0 and 1 of what it wrote
+ *
+ * Returns:
+ *  - 1 if anything differs or an error occurs, 0 otherwise
+ */
+static int check_render(const char *maze_file, const char *path_file,
+                        const char *out_name, const struct image *level0,
+                        const struct image *level1) {
+    char out_dir[128];
+    char command[512];
+    snprintf(out_dir, sizeof(out_dir), "%s/%s", dir, out_name);
+    snprintf(command, sizeof(command), "./renderer %s %d %d %s 2 %s",
+             maze_file, NUM_ROWS, NUM_COLS, out_dir,
+             path_file == NULL ? "" : path_file);
+    if (system(command) != 0) {
+        printf("%s failed\n", command);
+        return 1;
+    }
+    int overlay = path_file != NULL;
+    return check_level(out_dir, 0, level0, overlay) ||
+           check_level(out_dir, 1, level1, overlay);
+}
+
+int main(void) {
+    if (mkdtemp(dir) == NULL) {
+        fprintf(stderr, "Could not create a directory to check in.\n");
+        return 1;
+    }
+    char maze_file[64], path_file[64];
+    snprintf(maze_file, sizeof(maze_file), "%s/maze.txt", dir);
+    snprintf(path_file, sizeof(path_file), "%s/path.txt", dir);
+
+    struct maze *m = maze_create(NUM_ROWS, NUM_COLS);
+    FILE *f = NULL;
+    int err = m == NULL || maze_generate(m, 7) == 1 ||
+              maze_save(m, maze_file, MAZE_HEX) == 1 ||
+              maze_solve(m, 0, 0, NUM_ROWS - 1, NUM_COLS - 1, NULL) != 1 ||
+              (f = fopen(path_file, "w")) == NULL ||
+              maze_write_pruned_path(m, 0, 0, f) == 1;
+    if (f != NULL && fclose(f) == EOF) {
+        err = 1;
+    }
+    struct image level0, level1;
+    memset(&level0, 0, sizeof(level0));
+    memset(&level1, 0, sizeof(level1));
+    if (err == 0) {
+        err = alloc_image(&level0, 2 * NUM_COLS + 1, 2 * NUM_ROWS + 1);
+    }
+    if (err == 0) {
+        draw_maze(m, &level0);
+        err = draw_path(path_file, &level0) < 2 || shrink(&level0, &level1);
+    }
+    if (err == 1) {
+        fprintf(stderr, "Could not set up the check.\n");
+    }
+    if (err == 0 && check_render(maze_file, NULL, "plain", &level0,
+                                 &level1) == 1) {
+        printf("render without a path failed\n");
+        err = 1;
+    }
+    if (err == 0 && check_render(maze_file, path_file, "overlay", &level0,
+                                 &level1) == 1) {
+        printf("render with a path failed\n");
+        err = 1;
+    }
+    maze_destroy(m);
+    free_image(&level0);
+    free_image(&level1);
+
+    char command[128];
+    snprintf(command, sizeof(command), "rm -rf %s", dir);
+    if (system(command) != 0) {
+        fprintf(stderr, "Could not remove %s.\n", dir);
+    }
+    if (err == 0) {
+        printf("renderer levels 0 and 1 match, with and without a path\n");
+    }
+    return err;
+}
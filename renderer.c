@@ -0,0 +1,716 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "maze.h"
+
+/*
+ * Streaming tiled renderer.
+ *
+ * At full resolution (level 0) every room is one pixel at (2 * row + 1,
+ * 2 * col + 1), with a one pixel wall (or gap) between neighbouring rooms,
+ * so a num_rows x num_cols maze is a (2 * num_rows + 1) x (2 * num_cols + 1)
+ * image. Level n + 1 halves level n in each direction, averaging 2x2 blocks,
+ * until the whole maze fits in a single tile. Tiles are TILE_SIZE pixels
+ * square (smaller along the right and bottom edges) and are written to
+ * <output directory>/<level>/<tile row>_<tile column>.pgm.
+ *
+ * A path overlay is kept apart from the maze as a mask per level: a pixel of
+ * level n + 1 is on the path if any of the 2x2 pixels of level n it comes
+ * from is, while the maze itself is averaged without it. With an overlay the
+ * tiles are written as PPMs instead (.ppm), with the maze in gray and the
+ * path painted in PATH_COLOR, which no gray level can be mistaken for.
+ *
+ * The maze is read a row at a time and rendered a band of TILE_SIZE pixel
+ * rows at a time, and each band is downsampled into the next level as soon
+ * as it is done, so memory use depends on the number of columns and not on
+ * the number of rows, nor on the length of the path. The tiles of a band are rendered and written by
+ * separate threads.
+ */
+
+#define TILE_SIZE 512
+
+/*
+ * Most temporary files a spill (see below) spreads path pixels over
+ */
+#define SPILL_FANOUT 64
+
+#define WALL 0
+#define OPEN 255
+static const unsigned char PATH_COLOR[3] = {255, 0, 0};
+
+/*
+ * The bits of a room's hex value, as decoded by create_room_connections: a
+ * set bit means there is a wall in that direction
+ */
+#define NORTH_WALL 1
+#define SOUTH_WALL 2
+#define WEST_WALL 4
+#define EAST_WALL 8
+
+/*
+ * One level of the pyramid, with the band of pixel rows currently being
+ * filled
+ *
+ *  - width, height: size of the whole level in pixels
+ *  - band: TILE_SIZE rows of width pixels
+ *  - mask: like band, 1 where the path covers the pixel and 0 elsewhere, or
+ *    NULL if there is no path overlay
+ *  - band_y: the image row the band starts at
+ *  - filled: how many rows of the band have been filled
+ */
+struct level {
+    int width;
+    int height;
+    unsigned char *band;
+    unsigned char *mask;
+    int band_y;
+    int filled;
+};
+
+/*
+ * The rows of the maze that the current band of level 0 needs, kept in a
+ * ring buffer indexed by row modulo num_window rows
+ */
+struct cell_window {
+    unsigned char *rows;
+    int num_window;
+    int num_cols;
+    int next_row;
+};
+
+/*
+ * A level 0 path pixel
+ */
+struct path_pixel {
+    int32_t y;
+    int32_t x;
+};
+
+/*
+ * Path pixels waiting for the band of level 0 they fall in, spread over up
+ * to SPILL_FANOUT temporary files that each hold bands_per_file consecutive
+ * bands. When a file holding more than one band comes up, it is split into a
+ * child spill of its own, so each pixel is read back a few times at most
+ * however many bands there are, and memory stays the same however long the
+ * path is.
+ */
+struct spill {
+    FILE *files[SPILL_FANOUT];
+    int first_band;
+    int bands_per_file;
+    struct spill *child;
+};
+
+struct renderer {
+    const char *out_dir;
+    int num_rows;
+    int num_cols;
+    int num_levels;
+    struct level *levels;
+    struct cell_window window;
+    int overlay;
+    struct spill path;
+    int num_threads;
+    // one per thread, allocated once by renderer_init
+    pthread_t *threads;
+    struct tile_job *jobs;
+};
+
+/*
+ * Work for one thread: every num_threads-th tile of the current band of a
+ * level, starting from tile column first
+ */
+struct tile_job {
+    struct renderer *r;
+    int level;
+    int first;
+    int err;
+};
+
+static const unsigned char *cell_row(const struct cell_window *w, int row) {
+    return &w->rows[(size_t)(row % w->num_window) * (size_t)w->num_cols];
+}
+
+/*
+ * Computes one pixel of level 0
+ *
+ * Parameters:
+ *  - r: the renderer, with every maze row around image row y in its window
+ *  - y, x: the pixel
+ *
+ * Returns:
+ *  - WALL or OPEN
+ */
+static unsigned char maze_pixel(const struct renderer *r, int y, int x) {
+    const struct cell_window *w = &r->window;
+    if (y % 2 == 1) {
+        const unsigned char *row = cell_row(w, (y - 1) / 2);
+        if (x % 2 == 1) {
+            return OPEN;
+        }
+        int col = x / 2;
+        if (col == r->num_cols) {
+            return (row[col - 1] & EAST_WALL) ? WALL : OPEN;
+        }
+        return (row[col] & WEST_WALL) ? WALL : OPEN;
+    }
+    if (x % 2 == 0) {
+        return WALL;
+    }
+    int row = y / 2;
+    int col = (x - 1) / 2;
+    if (row == r->num_rows) {
+        return (cell_row(w, row - 1)[col] & SOUTH_WALL) ? WALL : OPEN;
+    }
+    return (cell_row(w, row)[col] & NORTH_WALL) ? WALL : OPEN;
+}
+
+/*
+ * Writes a tile of the current band of a level as a binary PGM, or as a
+ * binary PPM with the path painted over it if there is an overlay
+ *
+ * Parameters:
+ *  - r: the renderer
+ *  - level: the level the tile belongs to
+ *  - tile_x: the tile column
+ *
+ * Returns:
+ *  - 1 if an error occurs, 0 otherwise
+ */
+static int write_tile(const struct renderer *r, int level, int tile_x) {
+    const struct level *l = &r->levels[level];
+    int x0 = tile_x * TILE_SIZE;
+    int width = l->width - x0 < TILE_SIZE ? l->width - x0 : TILE_SIZE;
+
+    char file_name[4096];
+    snprintf(file_name, sizeof(file_name), "%s/%d/%d_%d.%s", r->out_dir, level,
+             l->band_y / TILE_SIZE, tile_x, r->overlay ? "ppm" : "pgm");
+    FILE *f = fopen(file_name, "wb");
+    if (f == NULL) {
+        fprintf(stderr, "Error opening file %s.\n", file_name);
+        return 1;
+    }
+    int err = fprintf(f, "%s\n%d %d\n255\n", r->overlay ? "P6" : "P5", width,
+                      l->filled) < 0;
+    unsigned char rgb[3 * TILE_SIZE];
+    for (int y = 0; y < l->filled && err == 0; y++) {
+        const unsigned char *row = &l->band[(size_t)y * l->width + x0];
+        if (!r->overlay) {
+            err = fwrite(row, 1, width, f) != (size_t)width;
+            continue;
+        }
+        const unsigned char *mask = &l->mask[(size_t)y * l->width + x0];
+        for (int x = 0; x < width; x++) {
+            if (mask[x] != 0) {
+                memcpy(&rgb[3 * x], PATH_COLOR, 3);
+            } else {
+                rgb[3 * x] = rgb[3 * x + 1] = rgb[3 * x + 2] = row[x];
+            }
+        }
+        err = fwrite(rgb, 3, width, f) != (size_t)width;
+    }
+    if (fclose(f) == EOF || err != 0) {
+        fprintf(stderr, "Writing to file %s failed.\n", file_name);
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * Renders (for level 0) and writes this job's tiles of the current band
+ */
+static void *render_tiles(void *arg) {
+    struct tile_job *job = arg;
+    struct renderer *r = job->r;
+    struct level *l = &r->levels[job->level];
+    int tiles_x = (l->width + TILE_SIZE - 1) / TILE_SIZE;
+
+    for (int tx = job->first; tx < tiles_x; tx += r->num_threads) {
+        if (job->level == 0) {
+            int x0 = tx * TILE_SIZE;
+            int x1 = x0 + TILE_SIZE < l->width ? x0 + TILE_SIZE : l->width;
+            for (int y = 0; y < l->filled; y++) {
+                unsigned char *row = &l->band[(size_t)y * l->width];
+                for (int x = x0; x < x1; x++) {
+                    row[x] = maze_pixel(r, l->band_y + y, x);
+                }
+            }
+        }
+        if (write_tile(r, job->level, tx) == 1) {
+            job->err = 1;
+            return NULL;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Renders and writes every tile of the current band of a level, spread
+ * across the renderer's threads
+ *
+ * Returns:
+ *  - 1 if an error occurs, 0 otherwise
+ */
+static int render_band(struct renderer *r, int level) {
+    pthread_t *threads = r->threads;
+    struct tile_job *jobs = r->jobs;
+    int started = 0;
+    int err = 0;
+    for (int t = 0; t < r->num_threads; t++) {
+        jobs[t].r = r;
+        jobs[t].level = level;
+        jobs[t].first = t;
+        jobs[t].err = 0;
+        if (t == 0) {
+            continue;
+        }
+        if (pthread_create(&threads[t], NULL, render_tiles, &jobs[t]) != 0) {
+            fprintf(stderr, "Could not start thread.\n");
+            err = 1;
+            break;
+        }
+        started = t;
+    }
+    // the calling thread takes the first share itself
+    if (err == 0) {
+        render_tiles(&jobs[0]);
+        err = jobs[0].err;
+    }
+    for (int t = 1; t <= started; t++) {
+        pthread_join(threads[t], NULL);
+        err |= jobs[t].err;
+    }
+    return err;
+}
+
+/*
+ * Adds the rows of a finished band of one level to the band of the next,
+ * averaging 2x2 blocks (and combining their path masks with OR), and writes
+ * the next level's band whenever it fills up
+ *
+ * Parameters:
+ *  - r: the renderer
+ *  - level: the level whose band is finished
+ *
+ * Returns:
+ *  - 1 if an error occurs, 0 otherwise
+ */
+static int downsample_band(struct renderer *r, int level) {
+    if (level + 1 >= r->num_levels) {
+        return 0;
+    }
+    struct level *src = &r->levels[level];
+    struct level *dst = &r->levels[level + 1];
+    for (int y = 0; y < src->filled; y += 2) {
+        const unsigned char *top = &src->band[(size_t)y * src->width];
+        const unsigned char *bottom =
+            y + 1 < src->filled ? top + src->width : top;
+        unsigned char *out = &dst->band[(size_t)dst->filled * dst->width];
+        for (int x = 0; x < dst->width; x++) {
+            int x1 = 2 * x + 1 < src->width ? 2 * x + 1 : 2 * x;
+            out[x] = (top[2 * x] + top[x1] + bottom[2 * x] + bottom[x1] + 2) / 4;
+        }
+        if (dst->mask != NULL) {
+            const unsigned char *mask_top = &src->mask[(size_t)y * src->width];
+            const unsigned char *mask_bottom =
+                y + 1 < src->filled ? mask_top + src->width : mask_top;
+            unsigned char *mask_out =
+                &dst->mask[(size_t)dst->filled * dst->width];
+            for (int x = 0; x < dst->width; x++) {
+                int x1 = 2 * x + 1 < src->width ? 2 * x + 1 : 2 * x;
+                mask_out[x] = mask_top[2 * x] | mask_top[x1] |
+                              mask_bottom[2 * x] | mask_bottom[x1];
+            }
+        }
+        dst->filled++;
+        if (dst->filled == TILE_SIZE ||
+            dst->band_y + dst->filled == dst->height) {
+            if (render_band(r, level + 1) == 1 ||
+                downsample_band(r, level + 1) == 1) {
+                return 1;
+            }
+            dst->band_y += dst->filled;
+            dst->filled = 0;
+        }
+    }
+    return 0;
+}
+
+static void spill_init(struct spill *s, int first_band, int num_bands) {
+    memset(s, 0, sizeof(struct spill));
+    s->first_band = first_band;
+    s->bands_per_file = (num_bands + SPILL_FANOUT - 1) / SPILL_FANOUT;
+}
+
+static void spill_destroy(struct spill *s) {
+    for (int i = 0; i < SPILL_FANOUT; i++) {
+        if (s->files[i] != NULL) {
+            fclose(s->files[i]);
+        }
+    }
+    if (s->child != NULL) {
+        spill_destroy(s->child);
+        free(s->child);
+    }
+    memset(s, 0, sizeof(struct spill));
+}
+
+/*
+ * Adds a pixel to the file of the band it falls in
+ *
+ * Returns:
+ *  - 1 if an error occurs, 0 otherwise
+ */
+static int spill_add(struct spill *s, struct path_pixel p) {
+    int i = (p.y / TILE_SIZE - s->first_band) / s->bands_per_file;
+    if (s->files[i] == NULL) {
+        s->files[i] = tmpfile();
+        if (s->files[i] == NULL) {
+            fprintf(stderr, "Could not create temporary file.\n");
+            return 1;
+        }
+    }
+    if (fwrite(&p, sizeof(p), 1, s->files[i]) != 1) {
+        fprintf(stderr, "Writing to temporary file failed.\n");
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * Takes the file holding a band out of a spill: the file itself if it holds
+ * only that band, or else the file from a child spill the file is split into
+ * when the first of its bands comes up. Bands must be taken in order.
+ *
+ * Parameters:
+ *  - s: the spill
+ *  - band: the band of level 0
+ *  - f: set to the file holding the band's pixels, which the caller must
+ *    close, or NULL if there are none
+ *
+ * Returns:
+ *  - 1 if an error occurs, 0 otherwise
+ */
+static int spill_take(struct spill *s, int band, FILE **f) {
+    int i = (band - s->first_band) / s->bands_per_file;
+    *f = NULL;
+    if (s->bands_per_file == 1) {
+        *f = s->files[i];
+        s->files[i] = NULL;
+        return 0;
+    }
+    if (s->files[i] != NULL) {
+        if (s->child == NULL) {
+            s->child = malloc(sizeof(struct spill));
+            if (s->child == NULL) {
+                fprintf(stderr, "Could not allocate path.\n");
+                return 1;
+            }
+        } else {
+            spill_destroy(s->child);
+        }
+        spill_init(s->child, s->first_band + i * s->bands_per_file,
+                   s->bands_per_file);
+        FILE *from = s->files[i];
+        s->files[i] = NULL;
+        rewind(from);
+        struct path_pixel p;
+        int err = 0;
+        while (err == 0 && fread(&p, sizeof(p), 1, from) == 1) {
+            err = spill_add(s->child, p);
+        }
+        err |= ferror(from) != 0;
+        fclose(from);
+        if (err != 0) {
+            return 1;
+        }
+    }
+    if (s->child != NULL && band >= s->child->first_band &&
+        band < s->child->first_band + s->bands_per_file) {
+        return spill_take(s->child, band, f);
+    }
+    return 0;
+}
+
+/*
+ * Reads a PRUNED or FULL path file written by the solver into the level 0
+ * pixels it covers: each room on it, and the gap between each pair of
+ * neighbouring rooms that follow each other in it. The pixels go to the
+ * renderer's spill a few at a time, so the path is never all in memory.
+ *
+ * Parameters:
+ *  - r: the renderer, with the dimensions of the maze set
+ *  - file_name: the path file
+ *
+ * Returns:
+ *  - 1 if an error occurs, 0 otherwise
+ */
+static int read_path(struct renderer *r, const char *file_name) {
+    FILE *f = fopen(file_name, "r");
+    if (f == NULL) {
+        fprintf(stderr, "Error opening file.\n");
+        return 1;
+    }
+    char header[16];
+    if (fscanf(f, "%15s", header) != 1 ||
+        (strcmp(header, "PRUNED") != 0 && strcmp(header, "FULL") != 0)) {
+        fprintf(stderr, "Not a PRUNED or FULL path file.\n");
+        fclose(f);
+        return 1;
+    }
+
+    int height = 2 * r->num_rows + 1;
+    spill_init(&r->path, 0, (height + TILE_SIZE - 1) / TILE_SIZE);
+    int row, col, prev_row = -1, prev_col = -1;
+    while (fscanf(f, "%d, %d", &row, &col) == 2) {
+        if (row < 0 || row >= r->num_rows || col < 0 || col >= r->num_cols) {
+            fprintf(stderr, "Path leaves the maze.\n");
+            fclose(f);
+            return 1;
+        }
+        struct path_pixel room = {2 * row + 1, 2 * col + 1};
+        if (spill_add(&r->path, room) == 1) {
+            fclose(f);
+            return 1;
+        }
+        if (abs(row - prev_row) + abs(col - prev_col) == 1) {
+            struct path_pixel gap = {row + prev_row + 1, col + prev_col + 1};
+            if (spill_add(&r->path, gap) == 1) {
+                fclose(f);
+                return 1;
+            }
+        }
+        prev_row = row;
+        prev_col = col;
+    }
+    fclose(f);
+    return 0;
+}
+
+/*
+ * Creates a directory, succeeding if it already exists
+ */
+static int make_dir(const char *dir_name) {
+    if (mkdir(dir_name, 0777) != 0 && errno != EEXIST) {
+        fprintf(stderr, "Could not create directory %s.\n", dir_name);
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * Sets up the pyramid levels, their output directories and the window of
+ * maze rows
+ *
+ * Returns:
+ *  - 1 if an error occurs, 0 otherwise
+ */
+static int renderer_init(struct renderer *r) {
+    int width = 2 * r->num_cols + 1;
+    int height = 2 * r->num_rows + 1;
+    r->num_levels = 1;
+    while (width > TILE_SIZE || height > TILE_SIZE) {
+        width = (width + 1) / 2;
+        height = (height + 1) / 2;
+        r->num_levels++;
+    }
+    r->levels = calloc(r->num_levels, sizeof(struct level));
+    if (r->levels == NULL || make_dir(r->out_dir) == 1) {
+        return 1;
+    }
+    width = 2 * r->num_cols + 1;
+    height = 2 * r->num_rows + 1;
+    for (int i = 0; i < r->num_levels; i++) {
+        char dir_name[4096];
+        snprintf(dir_name, sizeof(dir_name), "%s/%d", r->out_dir, i);
+        if (make_dir(dir_name) == 1) {
+            return 1;
+        }
+        r->levels[i].width = width;
+        r->levels[i].height = height;
+        r->levels[i].band = malloc((size_t)TILE_SIZE * width);
+        if (r->overlay) {
+            r->levels[i].mask = malloc((size_t)TILE_SIZE * width);
+        }
+        if (r->levels[i].band == NULL ||
+            (r->overlay && r->levels[i].mask == NULL)) {
+            fprintf(stderr, "Could not allocate band.\n");
+            return 1;
+        }
+        width = (width + 1) / 2;
+        height = (height + 1) / 2;
+    }
+
+    // threads beyond one per tile column of level 0 would have nothing to do
+    int tiles_x = (r->levels[0].width + TILE_SIZE - 1) / TILE_SIZE;
+    if (r->num_threads > tiles_x) {
+        r->num_threads = tiles_x;
+    }
+    r->threads = malloc(sizeof(pthread_t) * r->num_threads);
+    r->jobs = malloc(sizeof(struct tile_job) * r->num_threads);
+    if (r->threads == NULL || r->jobs == NULL) {
+        fprintf(stderr, "Could not allocate threads.\n");
+        return 1;
+    }
+
+    // a band of TILE_SIZE pixel rows touches at most TILE_SIZE / 2 + 1 rows
+    r->window.num_window = TILE_SIZE / 2 + 1;
+    r->window.num_cols = r->num_cols;
+    r->window.next_row = 0;
+    r->window.rows = malloc((size_t)r->window.num_window * r->num_cols);
+    if (r->window.rows == NULL) {
+        fprintf(stderr, "Could not allocate rows.\n");
+        return 1;
+    }
+    return 0;
+}
+
+static void renderer_destroy(struct renderer *r) {
+    if (r->levels != NULL) {
+        for (int i = 0; i < r->num_levels; i++) {
+            free(r->levels[i].band);
+            free(r->levels[i].mask);
+        }
+    }
+    free(r->levels);
+    free(r->window.rows);
+    spill_destroy(&r->path);
+    free(r->threads);
+    free(r->jobs);
+}
+
+/*
+ * Fills the path mask of the current band of level 0 from the renderer's
+ * spill
+ *
+ * Returns:
+ *  - 1 if an error occurs, 0 otherwise
+ */
+static int mark_path(struct renderer *r) {
+    struct level *l = &r->levels[0];
+    memset(l->mask, 0, (size_t)l->filled * l->width);
+    int band = l->band_y / TILE_SIZE;
+    FILE *f;
+    if (spill_take(&r->path, band, &f) == 1) {
+        return 1;
+    }
+    if (f == NULL) {
+        return 0;
+    }
+    rewind(f);
+    struct path_pixel p;
+    while (fread(&p, sizeof(p), 1, f) == 1) {
+        l->mask[(size_t)(p.y - l->band_y) * l->width + p.x] = 1;
+    }
+    int err = ferror(f) != 0;
+    fclose(f);
+    if (err != 0) {
+        fprintf(stderr, "Reading temporary file failed.\n");
+    }
+    return err;
+}
+
+/*
+ * Streams the maze through every level of the pyramid
+ *
+ * Parameters:
+ *  - r: the renderer
+ *  - maze_file: the open maze file
+ *  - format: MAZE_HEX or MAZE_PACKED
+ *
+ * Returns:
+ *  - 1 if an error occurs, 0 otherwise
+ */
+static int render(struct renderer *r, FILE *maze_file, maze_format format) {
+    struct level *l = &r->levels[0];
+    struct cell_window *w = &r->window;
+    while (l->band_y < l->height) {
+        l->filled = l->height - l->band_y < TILE_SIZE ? l->height - l->band_y
+                                                      : TILE_SIZE;
+        // read every maze row the band's last pixel row touches
+        int last_row = (l->band_y + l->filled - 1) / 2;
+        if (last_row >= r->num_rows) {
+            last_row = r->num_rows - 1;
+        }
+        while (w->next_row <= last_row) {
+            unsigned char *row = (unsigned char *)cell_row(w, w->next_row);
+            if (maze_read_row(maze_file, r->num_cols, format, row) == 1) {
+                return 1;
+            }
+            w->next_row++;
+        }
+        if (l->mask != NULL && mark_path(r) == 1) {
+            return 1;
+        }
+        if (render_band(r, 0) == 1 || downsample_band(r, 0) == 1) {
+            return 1;
+        }
+        l->band_y += l->filled;
+    }
+    return 0;
+}
+
+/*
+ * Main function
+ *
+ * Parameters:
+ *  - argc: the number of command line arguments - for this function 6 or 7
+ *  - **argv: a pointer to the first element in the command line
+ *            arguments array - for this function:
+ *            ["renderer", <input maze file>, <number of rows>, <number of
+ *columns>, <output directory>, <number of threads>, [<path file>]]
+ *
+ * Returns:
+ *  - 0 if program exits correctly, 1 if there is an error
+ */
+int main(int argc, char **argv) {
+    struct renderer r;
+    char *maze_file_name;
+    char *path_file_name = NULL;
+    memset(&r, 0, sizeof(r));
+    if (argc != 6 && argc != 7) {
+        printf("Incorrect number of arguments.\n");
+        printf("./renderer <input maze file> <number of rows>");
+        printf(" <number of columns> <output directory> <number of threads>");
+        printf(" [<path file>]\n");
+        return 1;
+    } else {
+        maze_file_name = argv[1];
+        r.num_rows = atoi(argv[2]);
+        r.num_cols = atoi(argv[3]);
+        r.out_dir = argv[4];
+        r.num_threads = atoi(argv[5]);
+        if (argc == 7) {
+            path_file_name = argv[6];
+        }
+    }
+    // the image is 2 * n + 1 pixels along each side
+    if ((r.num_rows <= 0) || (r.num_cols <= 0) || (r.num_threads <= 0) ||
+        (r.num_rows > (INT32_MAX - 1) / 2) || (r.num_cols > (INT32_MAX - 1) / 2)) {
+        return 1;
+    }
+
+    r.overlay = path_file_name != NULL;
+    if (r.overlay && read_path(&r, path_file_name) == 1) {
+        renderer_destroy(&r);
+        return 1;
+    }
+    maze_format format = maze_format_for_path(maze_file_name);
+    FILE *maze_file = fopen(maze_file_name, format == MAZE_PACKED ? "rb" : "r");
+    if (maze_file == NULL) {
+        fprintf(stderr, "Error opening file.\n");
+        renderer_destroy(&r);
+        return 1;
+    }
+    int err = renderer_init(&r) == 1 || render(&r, maze_file, format) == 1;
+    fclose(maze_file);
+    renderer_destroy(&r);
+    return err;
+}
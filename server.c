@@ -0,0 +1,746 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "cache.h"
+#include "maze.h"
+#include "server.h"
+
+/*
+ * Resident solver. Each request is a single line
+ *
+ *      <maze file> <number of rows> <number of columns> <starting row>
+ *      <starting column> <ending row> <ending column>
+ *
+ * and is answered with exactly what the PRUNED solver would write to its
+ * output path file, followed by an empty line. Requests that cannot be
+ * answered get "ERROR <reason>" and an empty line instead, and the line
+ * "STATS" gets the cache counters.
+ *
+ * Decoded mazes are kept in an LRU cache so that repeated queries against the
+ * same maze skip reading the file, and the answers themselves are memoized in
+ * a second, smaller LRU cache. Both are keyed on the maze file's size and
+ * modification time, so a maze that is rewritten on disk is read again.
+ *
+ * The socket server runs on one thread with non-blocking client sockets.
+ * Responses are queued per client and written as its socket takes them; a
+ * client that stops reading its responses has its own requests paused once
+ * MAX_PENDING_OUTPUT bytes are queued for it, and never holds up the others.
+ */
+
+/*
+ * Longest request line accepted from a socket client: a maze file path plus
+ * six numbers
+ */
+#define MAX_REQUEST_LEN (PATH_MAX + 128)
+
+/*
+ * Bytes of queued responses past which a socket client's requests stop being
+ * read until it has read some of them. A single response can still take the
+ * queue past this.
+ */
+#define MAX_PENDING_OUTPUT (1 << 20)
+
+struct server {
+    struct lru_cache *mazes;
+    struct lru_cache *results;
+    unsigned long queries;
+    unsigned long result_hits;
+    unsigned long maze_hits;
+    unsigned long maze_loads;
+};
+
+struct response {
+    char *text;
+    size_t len;
+};
+
+static volatile sig_atomic_t stop_serving = 0;
+
+static void handle_stop(int sig) {
+    (void)sig;
+    stop_serving = 1;
+}
+
+static void free_maze(void *value) {
+    maze_destroy(value);
+}
+
+static void free_response(void *value) {
+    struct response *r = value;
+    if (r != NULL) {
+        free(r->text);
+        free(r);
+    }
+}
+
+/*
+ * Builds a response from a printf-style format
+ *
+ * Returns:
+ *  - the new response, or NULL if memory runs out
+ */
+static struct response *format_response(const char *format, ...) {
+    struct response *r = malloc(sizeof(struct response));
+    if (r == NULL) {
+        return NULL;
+    }
+    FILE *f = open_memstream(&r->text, &r->len);
+    if (f == NULL) {
+        free(r);
+        return NULL;
+    }
+    va_list args;
+    va_start(args, format);
+    int err = vfprintf(f, format, args);
+    va_end(args);
+    if (fclose(f) == EOF || err < 0) {
+        free(r->text);
+        free(r);
+        return NULL;
+    }
+    return r;
+}
+
+/*
+ * Solves a maze from start to goal and captures the pruned path
+ *
+ * Parameters:
+ *  - m: the maze to solve
+ *  - start_row, start_col, goal_row, goal_col: the query
+ *
+ * Returns:
+ *  - the PRUNED output followed by an empty line, or NULL if an error occurs
+ */
+static struct response *solve_to_response(struct maze *m, int start_row,
+                                          int start_col, int goal_row,
+                                          int goal_col) {
+    if (maze_solve(m, start_row, start_col, goal_row, goal_col, NULL) < 0) {
+        return NULL;
+    }
+    struct response *r = malloc(sizeof(struct response));
+    if (r == NULL) {
+        return NULL;
+    }
+    FILE *f = open_memstream(&r->text, &r->len);
+    if (f == NULL) {
+        free(r);
+        return NULL;
+    }
+    int err = maze_write_pruned_path(m, start_row, start_col, f);
+    if (fputc('\n', f) == EOF) {
+        err = 1;
+    }
+    if (fclose(f) == EOF || err == 1) {
+        free(r->text);
+        free(r);
+        return NULL;
+    }
+    return r;
+}
+
+/*
+ * Smallest size a maze file with the given dimensions can have: one byte per
+ * room for MAZE_HEX (which may or may not end its rows with newlines), and
+ * exactly what maze_write produces for MAZE_PACKED
+ *
+ * Parameters:
+ *  - num_rows, num_cols: dimensions of the maze, with maze_size_bytes
+ *    nonzero
+ *  - format: MAZE_HEX or MAZE_PACKED
+ *
+ * Returns:
+ *  - the size in bytes
+ */
+static off_t min_file_bytes(int num_rows, int num_cols, maze_format format) {
+    if (format == MAZE_PACKED) {
+        return (off_t)num_rows * (((off_t)num_cols + 1) / 2);
+    }
+    return (off_t)num_rows * (off_t)num_cols;
+}
+
+/*
+ * Answers a single request line
+ *
+ * Parameters:
+ *  - s: the server state
+ *  - line: the request, without its newline
+ *  - owned: set to 1 if the caller must free the response with
+ *    free_response, 0 if it belongs to the result cache
+ *
+ * Returns:
+ *  - the response, or NULL if memory runs out
+ */
+static struct response *answer(struct server *s, const char *line,
+                               int *owned) {
+    int num_rows, num_cols, start_row, start_col, goal_row, goal_col;
+    struct stat st;
+    *owned = 1;
+
+    if (strcmp(line, "STATS") == 0) {
+        return format_response(
+            "STATS queries=%lu result_hits=%lu maze_hits=%lu maze_loads=%lu"
+            " mazes=%zu maze_bytes=%zu results=%zu result_bytes=%zu\n\n",
+            s->queries, s->result_hits, s->maze_hits, s->maze_loads,
+            lru_count(s->mazes), lru_size(s->mazes), lru_count(s->results),
+            lru_size(s->results));
+    }
+
+    s->queries++;
+    char *maze_file_name = malloc(strlen(line) + 1);
+    if (maze_file_name == NULL) {
+        return NULL;
+    }
+    if (sscanf(line, "%s %d %d %d %d %d %d", maze_file_name, &num_rows,
+               &num_cols, &start_row, &start_col, &goal_row, &goal_col) != 7) {
+        free(maze_file_name);
+        return format_response("ERROR malformed request\n\n");
+    }
+    if ((maze_size_bytes(num_rows, num_cols) == 0) ||
+        (start_row < 0) || (start_row >= num_rows) ||
+        (start_col < 0) || (start_col >= num_cols) ||
+        (goal_row < 0) || (goal_row >= num_rows) ||
+        (goal_col < 0) || (goal_col >= num_cols)) {
+        free(maze_file_name);
+        return format_response("ERROR out of range\n\n");
+    }
+    if (stat(maze_file_name, &st) != 0) {
+        free(maze_file_name);
+        return format_response("ERROR could not open maze file\n\n");
+    }
+
+    char maze_key[64];
+    snprintf(maze_key, sizeof(maze_key), "\n%d %d %lld.%09ld %lld", num_rows,
+             num_cols, (long long)st.st_mtim.tv_sec, (long)st.st_mtim.tv_nsec,
+             (long long)st.st_size);
+    size_t key_len = strlen(maze_file_name) + strlen(maze_key) + 64;
+    char *key = malloc(key_len);
+    if (key == NULL) {
+        free(maze_file_name);
+        return NULL;
+    }
+    int maze_key_len = snprintf(key, key_len, "%s%s", maze_file_name, maze_key);
+    snprintf(key + maze_key_len, key_len - maze_key_len, " %d %d %d %d",
+             start_row, start_col, goal_row, goal_col);
+
+    struct response *r = lru_get(s->results, key);
+    if (r != NULL) {
+        s->result_hits++;
+        *owned = 0;
+        free(maze_file_name);
+        free(key);
+        return r;
+    }
+
+    // look the maze up under the key without the query
+    key[maze_key_len] = '\0';
+    int loaded = 0;
+    struct maze *m = lru_get(s->mazes, key);
+    if (m != NULL) {
+        s->maze_hits++;
+    } else {
+        // refuse before allocating anything: the grid is decoded at
+        // maze_size_bytes, far more than the file takes up
+        size_t maze_bytes = maze_size_bytes(num_rows, num_cols);
+        if (maze_bytes > lru_capacity(s->mazes)) {
+            free(maze_file_name);
+            free(key);
+            return format_response("ERROR maze larger than cache\n\n");
+        }
+        if (st.st_size < min_file_bytes(num_rows, num_cols,
+                                        maze_format_for_path(maze_file_name))) {
+            free(maze_file_name);
+            free(key);
+            return format_response("ERROR maze file too short\n\n");
+        }
+        // evict first so the cache never holds more than its cap, even
+        // while the new maze is being read
+        lru_reserve(s->mazes, maze_bytes);
+        m = maze_create(num_rows, num_cols);
+        if (m == NULL) {
+            free(maze_file_name);
+            free(key);
+            return format_response("ERROR could not allocate maze\n\n");
+        }
+        if (maze_load(m, maze_file_name,
+                      maze_format_for_path(maze_file_name)) == 1) {
+            maze_destroy(m);
+            free(maze_file_name);
+            free(key);
+            return format_response("ERROR could not read maze file\n\n");
+        }
+        s->maze_loads++;
+        loaded = 1;
+    }
+
+    r = solve_to_response(m, start_row, start_col, goal_row, goal_col);
+    if (loaded == 1 &&
+        lru_put(s->mazes, key, m, maze_size_bytes(num_rows, num_cols)) == 1) {
+        maze_destroy(m);
+    }
+    if (r == NULL) {
+        free(maze_file_name);
+        free(key);
+        return format_response("ERROR could not solve maze\n\n");
+    }
+
+    key[maze_key_len] = ' ';
+    if (lru_put(s->results, key, r, r->len + key_len) == 0) {
+        *owned = 0;
+    }
+    free(maze_file_name);
+    free(key);
+    return r;
+}
+
+/*
+ * Sets up the caches. An eighth of the memory goes to memoized results and
+ * the rest to decoded mazes.
+ *
+ * Returns:
+ *  - 1 if an error occurs, 0 otherwise
+ */
+static int server_init(struct server *s, size_t cache_bytes) {
+    memset(s, 0, sizeof(struct server));
+    s->mazes = lru_create(cache_bytes - cache_bytes / 8, free_maze);
+    s->results = lru_create(cache_bytes / 8, free_response);
+    if (s->mazes == NULL || s->results == NULL) {
+        fprintf(stderr, "Could not allocate caches.\n");
+        lru_destroy(s->mazes);
+        lru_destroy(s->results);
+        return 1;
+    }
+    return 0;
+}
+
+static void server_destroy(struct server *s) {
+    lru_destroy(s->mazes);
+    lru_destroy(s->results);
+}
+
+/*
+ * Answers a request line and hands back the text to send
+ *
+ * Parameters:
+ *  - s: the server state
+ *  - line: the request line, modified in place to strip the newline
+ *  - text, len: set to the response to send
+ *  - owned: set to the response the caller must free, or NULL
+ *
+ * Returns:
+ *  - nothing
+ */
+static void handle_line(struct server *s, char *line, const char **text,
+                       size_t *len, struct response **owned) {
+    static const char no_memory[] = "ERROR out of memory\n\n";
+    size_t n = strlen(line);
+    while (n > 0 && (line[n - 1] == '\n' || line[n - 1] == '\r')) {
+        line[--n] = '\0';
+    }
+    int is_owned;
+    struct response *r = answer(s, line, &is_owned);
+    *owned = is_owned == 1 ? r : NULL;
+    if (r == NULL) {
+        *text = no_memory;
+        *len = sizeof(no_memory) - 1;
+    } else {
+        *text = r->text;
+        *len = r->len;
+    }
+}
+
+/*
+ * Serves requests read from stdin, writing responses to stdout, until end of
+ * file
+ *
+ * Parameters:
+ *  - cache_bytes: memory cap for the maze and result caches together
+ *
+ * Returns:
+ *  - 1 if an error occurs, 0 otherwise
+ */
+int serve_pipe(size_t cache_bytes) {
+    struct server s;
+    if (server_init(&s, cache_bytes) == 1) {
+        return 1;
+    }
+    char *line = NULL;
+    size_t cap = 0;
+    int err = 0;
+    while (getline(&line, &cap, stdin) != -1) {
+        if (line[0] == '\n') {
+            continue;
+        }
+        const char *text;
+        size_t len;
+        struct response *owned;
+        handle_line(&s, line, &text, &len, &owned);
+        size_t written = fwrite(text, 1, len, stdout);
+        free_response(owned);
+        if (written != len || fflush(stdout) == EOF) {
+            fprintf(stderr, "Error printing to file.\n");
+            err = 1;
+            break;
+        }
+    }
+    free(line);
+    server_destroy(&s);
+    return err;
+}
+
+/*
+ * A connected client: the part of its input that has not been answered yet
+ * and the part of its responses that has not been written yet
+ */
+struct client {
+    int fd;
+    char *buf;
+    size_t len;
+    size_t cap;
+    char *out;
+    size_t out_len;
+    size_t out_pos;
+    size_t out_cap;
+    int closing;
+};
+
+static size_t pending_output(const struct client *c) {
+    return c->out_len - c->out_pos;
+}
+
+/*
+ * Appends a response to a client's output buffer
+ *
+ * Returns:
+ *  - 1 if memory runs out, 0 otherwise
+ */
+static int queue_output(struct client *c, const char *text, size_t len) {
+    if (c->out_pos > 0) {
+        c->out_len -= c->out_pos;
+        memmove(c->out, c->out + c->out_pos, c->out_len);
+        c->out_pos = 0;
+    }
+    if (c->out_len + len > c->out_cap) {
+        size_t cap = c->out_cap == 0 ? 4096 : c->out_cap;
+        while (cap < c->out_len + len) {
+            cap *= 2;
+        }
+        char *out = realloc(c->out, cap);
+        if (out == NULL) {
+            return 1;
+        }
+        c->out = out;
+        c->out_cap = cap;
+    }
+    memcpy(c->out + c->out_len, text, len);
+    c->out_len += len;
+    return 0;
+}
+
+/*
+ * Writes as much of a client's output buffer as its socket takes without
+ * blocking
+ *
+ * Returns:
+ *  - 1 if the client should be disconnected, 0 otherwise
+ */
+static int flush_client(struct client *c) {
+    while (c->out_pos < c->out_len) {
+        ssize_t n = write(c->fd, c->out + c->out_pos, c->out_len - c->out_pos);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return !(errno == EAGAIN || errno == EWOULDBLOCK);
+        }
+        c->out_pos += (size_t)n;
+    }
+    c->out_pos = 0;
+    c->out_len = 0;
+    return 0;
+}
+
+/*
+ * Answers the complete lines in a client's input, stopping early once its
+ * output buffer holds MAX_PENDING_OUTPUT bytes. A client whose input fills up
+ * with no newline in it is queued an error and marked as closing, so no
+ * client can make the server buffer more than MAX_REQUEST_LEN bytes of input
+ * for it.
+ *
+ * Parameters:
+ *  - s: the server state
+ *  - c: the client to answer
+ *
+ * Returns:
+ *  - the number of responses queued, or -1 if memory runs out
+ */
+static int answer_lines(struct server *s, struct client *c) {
+    static const char too_long[] = "ERROR request too long\n\n";
+    int answered = 0;
+    char *start = c->buf;
+    char *end = c->buf + c->len;
+    char *newline;
+    while (pending_output(c) < MAX_PENDING_OUTPUT &&
+           (newline = memchr(start, '\n', (size_t)(end - start))) != NULL) {
+        *newline = '\0';
+        if (newline != start) {
+            const char *text;
+            size_t len;
+            struct response *owned;
+            handle_line(s, start, &text, &len, &owned);
+            int err = queue_output(c, text, len);
+            free_response(owned);
+            if (err == 1) {
+                return -1;
+            }
+            answered++;
+        }
+        start = newline + 1;
+    }
+    c->len = (size_t)(end - start);
+    memmove(c->buf, start, c->len);
+    if (c->len > MAX_REQUEST_LEN && memchr(c->buf, '\n', c->len) == NULL) {
+        if (queue_output(c, too_long, sizeof(too_long) - 1) == 1) {
+            return -1;
+        }
+        c->len = 0;
+        c->closing = 1;
+        answered++;
+    }
+    return answered;
+}
+
+/*
+ * Reads what a client has sent if its socket is readable, answers what it
+ * can and writes what its socket takes. Input is not read while the client's
+ * output buffer is over MAX_PENDING_OUTPUT, so a client that does not read
+ * its responses only stops its own requests from being answered.
+ *
+ * Parameters:
+ *  - s: the server state
+ *  - c: the client to serve
+ *  - revents: the events poll reported for the client's socket
+ *
+ * Returns:
+ *  - 1 if the client should be disconnected, 0 otherwise
+ */
+static int serve_client(struct server *s, struct client *c, short revents) {
+    if (c->buf == NULL) {
+        // room for the longest request, its newline and one byte more, which
+        // tells a line that is too long apart from one that just fits
+        c->cap = MAX_REQUEST_LEN + 2;
+        c->buf = malloc(c->cap);
+        if (c->buf == NULL) {
+            return 1;
+        }
+    }
+    if ((revents & (POLLIN | POLLHUP | POLLERR)) != 0 && c->closing == 0 &&
+        pending_output(c) < MAX_PENDING_OUTPUT) {
+        // answer_lines leaves at most MAX_REQUEST_LEN bytes unless the output
+        // buffer is full, so there is always room to read into here
+        ssize_t n = read(c->fd, c->buf + c->len, c->cap - c->len);
+        if (n == 0) {
+            c->closing = 1;
+        } else if (n > 0) {
+            c->len += (size_t)n;
+        } else if (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK) {
+            return 1;
+        }
+    }
+
+    while (1) {
+        if (flush_client(c) == 1) {
+            return 1;
+        }
+        if (pending_output(c) >= MAX_PENDING_OUTPUT) {
+            break;
+        }
+        int answered = answer_lines(s, c);
+        if (answered < 0) {
+            return 1;
+        }
+        if (answered == 0) {
+            break;
+        }
+    }
+
+    if (c->closing == 1 && pending_output(c) == 0 &&
+        memchr(c->buf, '\n', c->len) == NULL) {
+        // closing with unread input resets the connection, which can lose
+        // the last response, so throw away (a bounded amount of) what is
+        // pending
+        for (int i = 0; i < 16; i++) {
+            if (read(c->fd, c->buf, c->cap) <= 0) {
+                break;
+            }
+        }
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * The poll events to wait for on a client's socket
+ */
+static short client_events(const struct client *c) {
+    short events = 0;
+    if (c->closing == 0 && pending_output(c) < MAX_PENDING_OUTPUT) {
+        events |= POLLIN;
+    }
+    if (pending_output(c) > 0) {
+        events |= POLLOUT;
+    }
+    return events;
+}
+
+static void close_client(struct client *c) {
+    close(c->fd);
+    free(c->buf);
+    free(c->out);
+}
+
+/*
+ * Serves requests from any number of clients connected to a Unix domain
+ * socket, until interrupted with SIGINT or SIGTERM
+ *
+ * Parameters:
+ *  - cache_bytes: memory cap for the maze and result caches together
+ *  - socket_path: where to create the socket (replacing any file there)
+ *
+ * Returns:
+ *  - 1 if an error occurs, 0 otherwise
+ */
+int serve_socket(size_t cache_bytes, const char *socket_path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Socket path too long.\n");
+        return 1;
+    }
+    strcpy(addr.sun_path, socket_path);
+
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        fprintf(stderr, "Could not create socket.\n");
+        return 1;
+    }
+    unlink(socket_path);
+    if (bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        listen(listen_fd, 64) != 0) {
+        fprintf(stderr, "Could not listen on %s.\n", socket_path);
+        close(listen_fd);
+        return 1;
+    }
+
+    struct server s;
+    if (server_init(&s, cache_bytes) == 1) {
+        close(listen_fd);
+        unlink(socket_path);
+        return 1;
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_stop;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    // fds[0] is the listening socket, fds[i] belongs to clients[i - 1]
+    struct pollfd *fds = malloc(sizeof(struct pollfd));
+    struct client *clients = NULL;
+    size_t num_clients = 0;
+    int err = 0;
+    if (fds == NULL) {
+        err = 1;
+        stop_serving = 1;
+    } else {
+        fds[0].fd = listen_fd;
+        fds[0].events = POLLIN;
+    }
+
+    while (stop_serving == 0) {
+        if (poll(fds, num_clients + 1, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            fprintf(stderr, "Error waiting for clients.\n");
+            err = 1;
+            break;
+        }
+        size_t i = 0;
+        while (i < num_clients) {
+            if (fds[i + 1].revents != 0 &&
+                serve_client(&s, &clients[i], fds[i + 1].revents) == 1) {
+                close_client(&clients[i]);
+                num_clients--;
+                clients[i] = clients[num_clients];
+                fds[i + 1] = fds[num_clients + 1];
+            } else {
+                fds[i + 1].events = client_events(&clients[i]);
+                i++;
+            }
+        }
+        if (fds[0].revents & POLLIN) {
+            int fd = accept(listen_fd, NULL, NULL);
+            if (fd < 0) {
+                continue;
+            }
+            int flags = fcntl(fd, F_GETFL);
+            if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+                close(fd);
+                continue;
+            }
+            struct pollfd *new_fds =
+                realloc(fds, (num_clients + 2) * sizeof(struct pollfd));
+            if (new_fds != NULL) {
+                fds = new_fds;
+            }
+            struct client *new_clients =
+                realloc(clients, (num_clients + 1) * sizeof(struct client));
+            if (new_clients != NULL) {
+                clients = new_clients;
+            }
+            if (new_fds == NULL || new_clients == NULL) {
+                close(fd);
+                continue;
+            }
+            clients[num_clients].fd = fd;
+            clients[num_clients].buf = NULL;
+            clients[num_clients].len = 0;
+            clients[num_clients].cap = 0;
+            clients[num_clients].out = NULL;
+            clients[num_clients].out_len = 0;
+            clients[num_clients].out_pos = 0;
+            clients[num_clients].out_cap = 0;
+            clients[num_clients].closing = 0;
+            fds[num_clients + 1].fd = fd;
+            fds[num_clients + 1].events = POLLIN;
+            fds[num_clients + 1].revents = 0;
+            num_clients++;
+        }
+    }
+
+    for (size_t i = 0; i < num_clients; i++) {
+        close_client(&clients[i]);
+    }
+    free(clients);
+    free(fds);
+    close(listen_fd);
+    unlink(socket_path);
+    server_destroy(&s);
+    return err;
+}
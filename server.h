@@ -0,0 +1,10 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stddef.h>
+
+int serve_pipe(size_t cache_bytes);
+
+int serve_socket(size_t cache_bytes, const char *socket_path);
+
+#endif
@@ -0,0 +1,374 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "maze.h"
+
+/*
+ * Checks `solver --serve` against the solver program: every answer, first
+ * computed and then memoized, must be exactly what ./solver writes to its
+ * path file for the same query, both through stdin/stdout and through a
+ * socket. Halfway through, the maze file is rewritten in place with another
+ * maze of the same size, and the answers must follow it.
+ */
+
+#define NUM_ROWS 30
+#define NUM_COLS 40
+#define NUM_QUERIES 20
+
+static char dir[] = "/tmp/server_check_XXXXXX";
+static char maze_path[64];
+static char path_path[64];
+static char socket_path[64];
+
+/*
+ * Reads a whole file into a string, appending extra
+ *
+ * Returns:
+ *  - the contents, or NULL if an error occurs
+ */
+static char *read_file(const char *file_name, const char *extra) {
+    FILE *f = fopen(file_name, "r");
+    if (f == NULL) {
+        return NULL;
+    }
+    char *text;
+    size_t len;
+    FILE *out = open_memstream(&text, &len);
+    if (out == NULL) {
+        fclose(f);
+        return NULL;
+    }
+    int c;
+    while ((c = getc(f)) != EOF) {
+        putc(c, out);
+    }
+    fputs(extra, out);
+    fclose(f);
+    if (fclose(out) == EOF) {
+        return NULL;
+    }
+    return text;
+}
+
+/*
+ * Reads one response: every line up to and including the empty line that
+ * ends it
+ *
+ * Returns:
+ *  - the response, or NULL if the server stops first
+ */
+static char *read_response(FILE *from) {
+    char *text;
+    size_t len;
+    FILE *out = open_memstream(&text, &len);
+    if (out == NULL) {
+        return NULL;
+    }
+    char *line = NULL;
+    size_t cap = 0;
+    int done = 0;
+    while (done == 0 && getline(&line, &cap, from) != -1) {
+        fputs(line, out);
+        done = strcmp(line, "\n") == 0;
+    }
+    free(line);
+    if (fclose(out) == EOF || done == 0) {
+        free(text);
+        return NULL;
+    }
+    return text;
+}
+
+/*
+ * Sends a request and reads its response
+ */
+static char *ask(FILE *to, FILE *from, const char *request) {
+    if (fprintf(to, "%s\n", request) < 0 || fflush(to) == EOF) {
+        return NULL;
+    }
+    return read_response(from);
+}
+
+/*
+ * Writes a maze generated from seed over the maze file, and moves its
+ * modification time to mtime so that even a coarse file system clock sees
+ * it change
+ *
+ * Returns:
+ *  - 1 if an error occurs, 0 otherwise
+ */
+static int write_maze(unsigned int seed, time_t mtime) {
+    struct maze *m = maze_create(NUM_ROWS, NUM_COLS);
+    if (m == NULL || maze_generate(m, seed) == 1 ||
+        maze_save(m, maze_path, MAZE_HEX) == 1) {
+        maze_destroy(m);
+        return 1;
+    }
+    maze_destroy(m);
+    struct timespec times[2];
+    times[0].tv_sec = mtime;
+    times[0].tv_nsec = 0;
+    times[1] = times[0];
+    return utimensat(AT_FDCWD, maze_path, times, 0) != 0;
+}
+
+/*
+ * Asks the server every query twice, the second time from its result cache,
+ * and compares the answers with ./solver's
+ *
+ * Parameters:
+ *  - to, from: the connection to the server
+ *  - queries: NUM_QUERIES start and goal rooms
+ *  - answers: set to the server's answers, freeing any already there
+ *
+ * Returns:
+ *  - 1 if an answer differs or an error occurs, 0 otherwise
+ */
+static int check_queries(FILE *to, FILE *from, int queries[][4],
+                         char *answers[]) {
+    for (int i = 0; i < 2 * NUM_QUERIES; i++) {
+        int *q = queries[i % NUM_QUERIES];
+        char command[256];
+        snprintf(command, sizeof(command), "./solver %s %d %d %s %d %d %d %d",
+                 maze_path, NUM_ROWS, NUM_COLS, path_path, q[0], q[1], q[2],
+                 q[3]);
+        if (system(command) != 0) {
+            printf("%s failed\n", command);
+            return 1;
+        }
+        char *expected = read_file(path_path, "\n");
+        char request[128];
+        snprintf(request, sizeof(request), "%s %d %d %d %d %d %d", maze_path,
+                 NUM_ROWS, NUM_COLS, q[0], q[1], q[2], q[3]);
+        char *actual = ask(to, from, request);
+        int same = expected != NULL && actual != NULL &&
+                   strcmp(expected, actual) == 0;
+        free(expected);
+        if (same == 0) {
+            printf("%s: answer differs from ./solver\n%s", request,
+                   actual == NULL ? "(none)\n" : actual);
+            free(actual);
+            return 1;
+        }
+        free(answers[i % NUM_QUERIES]);
+        answers[i % NUM_QUERIES] = actual;
+    }
+    return 0;
+}
+
+/*
+ * Checks that the STATS counters read as expected
+ */
+static int check_stats(FILE *to, FILE *from, unsigned long queries,
+                       unsigned long result_hits, unsigned long maze_loads) {
+    char expected[128];
+    snprintf(expected, sizeof(expected),
+             "STATS queries=%lu result_hits=%lu maze_hits=",
+             queries, result_hits);
+    char *actual = ask(to, from, "STATS");
+    char loads[64];
+    snprintf(loads, sizeof(loads), " maze_loads=%lu ", maze_loads);
+    int same = actual != NULL &&
+               strncmp(actual, expected, strlen(expected)) == 0 &&
+               strstr(actual, loads) != NULL;
+    if (same == 0) {
+        printf("expected %s...%s\ngot %s", expected, loads,
+               actual == NULL ? "(none)\n" : actual);
+    }
+    free(actual);
+    return !same;
+}
+
+/*
+ * Runs the whole check against one server connection
+ *
+ * Returns:
+ *  - 1 if anything differs or an error occurs, 0 otherwise
+ */
+static int check_server(FILE *to, FILE *from) {
+    int queries[NUM_QUERIES][4];
+    char *before[NUM_QUERIES] = {NULL};
+    char *after[NUM_QUERIES] = {NULL};
+    unsigned int state = 330;
+    for (int i = 0; i < NUM_QUERIES; i++) {
+        for (int j = 0; j < 4; j++) {
+            state = state * 1103515245u + 12345u;
+            queries[i][j] = (state >> 16) % (j % 2 == 0 ? NUM_ROWS : NUM_COLS);
+        }
+    }
+    time_t now = time(NULL);
+    int err = write_maze(1, now - 10) ||
+              check_queries(to, from, queries, before) ||
+              check_stats(to, from, 2 * NUM_QUERIES, NUM_QUERIES, 1);
+    // same size, new contents and modification time
+    err = err || write_maze(2, now - 5) ||
+          check_queries(to, from, queries, after) ||
+          check_stats(to, from, 4 * NUM_QUERIES, 2 * NUM_QUERIES, 2);
+    if (err == 0) {
+        int changed = 0;
+        for (int i = 0; i < NUM_QUERIES; i++) {
+            changed += strcmp(before[i], after[i]) != 0;
+        }
+        if (changed == 0) {
+            printf("no answer changed with the maze file\n");
+            err = 1;
+        }
+    }
+    if (err == 0) {
+        char *r = ask(to, from, "no such request");
+        if (r == NULL || strcmp(r, "ERROR malformed request\n\n") != 0) {
+            printf("malformed request got %s", r == NULL ? "(none)\n" : r);
+            err = 1;
+        }
+        free(r);
+    }
+    for (int i = 0; i < NUM_QUERIES; i++) {
+        free(before[i]);
+        free(after[i]);
+    }
+    return err;
+}
+
+/*
+ * Starts ./solver --serve, with its stdin and stdout connected to to and
+ * from if socket_name is NULL, or listening on socket_name otherwise
+ *
+ * Returns:
+ *  - the server's process id, or -1 if an error occurs
+ */
+static pid_t start_server(const char *socket_name, FILE **to, FILE **from) {
+    int requests[2], responses[2];
+    if (pipe(requests) != 0 || pipe(responses) != 0) {
+        return -1;
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        if (socket_name == NULL) {
+            dup2(requests[0], STDIN_FILENO);
+            dup2(responses[1], STDOUT_FILENO);
+        }
+        close(requests[0]);
+        close(requests[1]);
+        close(responses[0]);
+        close(responses[1]);
+        execl("./solver", "./solver", "--serve", "16", socket_name,
+              (char *)NULL);
+        _exit(127);
+    }
+    close(requests[0]);
+    close(responses[1]);
+    if (socket_name != NULL || pid < 0) {
+        close(requests[1]);
+        close(responses[0]);
+        return pid;
+    }
+    *to = fdopen(requests[1], "w");
+    *from = fdopen(responses[0], "r");
+    return pid;
+}
+
+/*
+ * Connects to the socket server, waiting up to five seconds for it to
+ * start listening
+ *
+ * Returns:
+ *  - 1 if an error occurs, 0 otherwise
+ */
+static int connect_server(FILE **to, FILE **from) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socket_path);
+    struct timespec wait = {0, 10000000};
+    for (int i = 0; i < 500; i++) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return 1;
+        }
+        if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
+            *to = fdopen(dup(fd), "w");
+            *from = fdopen(fd, "r");
+            return *to == NULL || *from == NULL;
+        }
+        close(fd);
+        nanosleep(&wait, NULL);
+    }
+    return 1;
+}
+
+int main(void) {
+    if (mkdtemp(dir) == NULL) {
+        fprintf(stderr, "Could not create a directory to check in.\n");
+        return 1;
+    }
+    snprintf(maze_path, sizeof(maze_path), "%s/maze.txt", dir);
+    snprintf(path_path, sizeof(path_path), "%s/path.txt", dir);
+    snprintf(socket_path, sizeof(socket_path), "%s/socket", dir);
+    signal(SIGPIPE, SIG_IGN);
+
+    // through stdin and stdout, which the server exits on closing
+    FILE *to = NULL, *from = NULL;
+    int status = 1;
+    pid_t pid = start_server(NULL, &to, &from);
+    int err = pid < 0 || to == NULL || from == NULL || check_server(to, from);
+    if (to != NULL) {
+        fclose(to);
+    }
+    if (from != NULL) {
+        fclose(from);
+    }
+    if (pid > 0 && (waitpid(pid, &status, 0) != pid || status != 0)) {
+        printf("server did not exit cleanly at end of input\n");
+        err = 1;
+    }
+    if (err == 1) {
+        printf("pipe server check failed\n");
+    }
+
+    // through a socket, which the server is stopped with SIGTERM on
+    if (err == 0) {
+        to = NULL;
+        from = NULL;
+        pid = start_server(socket_path, NULL, NULL);
+        err = pid < 0 || connect_server(&to, &from) == 1 ||
+              check_server(to, from);
+        if (to != NULL) {
+            fclose(to);
+        }
+        if (from != NULL) {
+            fclose(from);
+        }
+        if (pid > 0) {
+            kill(pid, SIGTERM);
+            if (waitpid(pid, &status, 0) != pid || status != 0) {
+                printf("server did not exit cleanly on SIGTERM\n");
+                err = 1;
+            }
+        }
+        if (err == 1) {
+            printf("socket server check failed\n");
+        }
+    }
+
+    unlink(maze_path);
+    unlink(path_path);
+    unlink(socket_path);
+    rmdir(dir);
+    if (err == 0) {
+        printf("server answers match ./solver, before and after the maze "
+               "file changes\n");
+    }
+    return err;
+}
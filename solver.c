@@ -1,7 +1,9 @@
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "server.h"
 #include "solver.h"
 
 /*
@@ -204,6 +206,7 @@ int read_encoded_maze_from_file(int num_rows, int num_cols,
     return 0;
 }
 
+#ifndef MAZE_LIB
 /*
  * Main function
  *
@@ -214,6 +217,8 @@ int read_encoded_maze_from_file(int num_rows, int num_cols,
  *            ["solver", <input maze file>, <number of rows>, <number of
  *columns> <output path file>, <starting row>, <starting column>, <ending row>,
  *<ending column>]
+ *            or, to keep running and answer queries (see server.c):
+ *            ["solver", "--serve", <cache size in MB>, [<socket path>]]
  *
  * Returns:
  *  - 0 if program exits correctly, 1 if there is an error
@@ -223,6 +228,24 @@ int main(int argc, char **argv) {
     int num_rows, num_cols, start_row, start_col, goal_row, goal_col;
     char *maze_file_name;
     char *path_file_name;
+    #ifndef FULL
+    if (argc >= 2 && strcmp(argv[1], "--serve") == 0) {
+        if (argc != 3 && argc != 4) {
+            printf("Incorrect number of arguments.\n");
+            printf("./solver --serve <cache size in MB> [<socket path>]\n");
+            return 1;
+        }
+        long cache_mb = atol(argv[2]);
+        if (cache_mb <= 0) {
+            return 1;
+        }
+        size_t cache_bytes = (size_t)cache_mb << 20;
+        if (argc == 3) {
+            return serve_pipe(cache_bytes);
+        }
+        return serve_socket(cache_bytes, argv[3]);
+    }
+    #endif
     if (argc != 9) {
         printf("Incorrect number of arguments.\n");
         printf(
@@ -291,4 +314,5 @@ int main(int argc, char **argv) {
         return 1;
     }
     return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -1,3 +1,8 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <stdio.h>
+
 #include "common.h"
 
 void create_room_connections(struct maze_room *room, unsigned int hex);
@@ -14,3 +19,5 @@ int print_pruned_path(struct maze_room *room, FILE *file);
 int read_encoded_maze_from_file(int num_rows, int num_cols,
                                 int encoded_maze[num_rows][num_cols],
                                 char *file_name);
+
+#endif